@@ -0,0 +1,147 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+void BenchmarkCounters::add(const char* name, uint64_t value)
+{
+	for (int i = 0; i < m_count; i++)
+	{
+		if (m_names[i] == name)
+		{
+			m_values[i] += value;
+			return;
+		}
+	}
+
+	if (m_count < kMaxCounters)
+	{
+		m_names[m_count] = name;
+		m_values[m_count] = value;
+		m_count++;
+	}
+}
+
+BenchmarkRunner::BenchmarkRunner(int warmup, int repetitions, const char* filter)
+	: m_warmup(warmup), m_repetitions(repetitions < 1 ? 1 : repetitions), m_filter(filter ? filter : "")
+{
+}
+
+void BenchmarkRunner::run(const char* name, const Body& body)
+{
+	if (!m_filter.empty() && std::string(name).find(m_filter) == std::string::npos)
+		return;
+
+	for (int i = 0; i < m_warmup; i++)
+	{
+		BenchmarkCounters counters;
+		body(counters);
+	}
+
+	std::vector<double> seconds;
+	std::vector<std::vector<double>> rates;
+	std::vector<const char*> names;
+	for (int i = 0; i < m_repetitions; i++)
+	{
+		BenchmarkCounters counters;
+		const auto start = std::chrono::steady_clock::now();
+		body(counters);
+		const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		seconds.push_back(elapsed);
+
+		// Counters are matched up by the order the body first reported them in
+		for (int c = 0; c < counters.getCount(); c++)
+		{
+			if (c >= (int)names.size())
+			{
+				names.push_back(counters.getName(c));
+				rates.emplace_back();
+			}
+			rates[c].push_back(elapsed > 0.0 ? counters.getValue(c) / elapsed : 0.0);
+		}
+	}
+
+	BenchmarkResult result;
+	result.name = name;
+	result.warmup = m_warmup;
+	result.repetitions = m_repetitions;
+	result.seconds = summarize("seconds", seconds);
+	for (size_t c = 0; c < names.size(); c++)
+		result.rates.push_back(summarize(names[c], rates[c]));
+	m_results.push_back(result);
+
+	printf("%-28s %9.3f ms", name, result.seconds.mean * 1000.0);
+	for (const BenchmarkStats& rate : result.rates)
+		printf("  %s %.4g/s (+-%.1f%%)", rate.name.c_str(), rate.mean, rate.mean > 0.0 ? 100.0 * rate.stddev / rate.mean : 0.0);
+	printf("\n");
+	fflush(stdout);
+}
+
+BenchmarkStats BenchmarkRunner::summarize(const char* name, std::vector<double>& samples)
+{
+	BenchmarkStats stats = { name, 0.0, 0.0, 0.0, 0.0, 0.0 };
+	if (samples.empty())
+		return stats;
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0.0;
+	for (double sample : samples)
+		sum += sample;
+	stats.mean = sum / samples.size();
+
+	// Sample standard deviation, since the repetitions are a sample of the machine's behaviour
+	double squares = 0.0;
+	for (double sample : samples)
+		squares += (sample - stats.mean) * (sample - stats.mean);
+	stats.stddev = samples.size() > 1 ? sqrt(squares / (samples.size() - 1)) : 0.0;
+
+	const size_t middle = samples.size() / 2;
+	stats.median = samples.size() % 2 ? samples[middle] : 0.5 * (samples[middle - 1] + samples[middle]);
+	stats.min = samples.front();
+	stats.max = samples.back();
+	return stats;
+}
+
+namespace
+{
+	void writeStats(std::ofstream& file, const BenchmarkStats& stats)
+	{
+		char line[256];
+		snprintf(line, sizeof(line), "{\"name\":\"%s\",\"mean\":%.9g,\"stddev\":%.9g,\"median\":%.9g,\"min\":%.9g,\"max\":%.9g}",
+			stats.name.c_str(), stats.mean, stats.stddev, stats.median, stats.min, stats.max);
+		file << line;
+	}
+}
+
+bool BenchmarkRunner::writeJson(const char* filePath, const char* revision) const
+{
+	std::ofstream file(filePath);
+	if (!file)
+		return false;
+
+	file << "{\"revision\":\"" << revision << "\",\"benchmarks\":[";
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		const BenchmarkResult& result = m_results[i];
+		file << (i ? ",\n" : "\n") << "{\"name\":\"" << result.name << "\",\"warmup\":" << result.warmup
+			<< ",\"repetitions\":" << result.repetitions << ",\"seconds\":";
+		writeStats(file, result.seconds);
+		file << ",\"rates\":[";
+		for (size_t r = 0; r < result.rates.size(); r++)
+		{
+			if (r)
+				file << ",";
+			writeStats(file, result.rates[r]);
+		}
+		file << "]}";
+	}
+	file << "\n]}\n";
+	return true;
+}
+
+void BenchmarkRunner::printSummary() const
+{
+	printf("%zu benchmarks, %d warmup and %d measured repetitions each\n", m_results.size(), m_warmup, m_repetitions);
+}
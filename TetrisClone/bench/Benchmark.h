@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Counts reported by one repetition of a benchmark, each turned into a rate over the repetition's time
+class BenchmarkCounters
+{
+public:
+	static constexpr int kMaxCounters = 4;
+
+	BenchmarkCounters() : m_count(0) {}
+
+	void add(const char* name, uint64_t value);
+
+	inline int getCount() const { return m_count; }
+	inline const char* getName(int index) const { return m_names[index]; }
+	inline uint64_t getValue(int index) const { return m_values[index]; }
+
+private:
+	const char* m_names[kMaxCounters];
+	uint64_t m_values[kMaxCounters];
+	int m_count;
+};
+
+// Summary of one counter's rate across repetitions, in units per second
+struct BenchmarkStats
+{
+	std::string name;
+	double mean;
+	double stddev;
+	double median;
+	double min;
+	double max;
+};
+
+struct BenchmarkResult
+{
+	std::string name;
+	int warmup;
+	int repetitions;
+	BenchmarkStats seconds;
+	std::vector<BenchmarkStats> rates;
+};
+
+// Runs each benchmark body a few times unmeasured, then times every repetition separately so
+// the output carries the spread as well as the average
+class BenchmarkRunner
+{
+public:
+	using Body = std::function<void(BenchmarkCounters&)>;
+
+	BenchmarkRunner(int warmup, int repetitions, const char* filter = nullptr);
+
+	void run(const char* name, const Body& body);
+
+	// The revision is written into the output so results can be lined up against commits
+	bool writeJson(const char* filePath, const char* revision) const;
+	void printSummary() const;
+
+private:
+	static BenchmarkStats summarize(const char* name, std::vector<double>& samples);
+
+private:
+	int m_warmup;
+	int m_repetitions;
+	std::string m_filter;
+	std::vector<BenchmarkResult> m_results;
+};
\ No newline at end of file
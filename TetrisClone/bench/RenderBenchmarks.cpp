@@ -0,0 +1,149 @@
+#include "RenderBenchmarks.h"
+#include "Benchmark.h"
+#include "Game/Board.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/DrawList.h"
+#include "Rendering/Shader.h"
+#include "Rendering/UniformBuffer.h"
+#include "Rendering/Framebuffer.h"
+#include "Rendering/ParticleSystem.h"
+#include "GL/glew.h"
+#include "GLFW/glfw3.h"
+#include <cstdio>
+
+#ifndef TETRIS_SHADER_DIRECTORY
+#define TETRIS_SHADER_DIRECTORY "res/shaders"
+#endif
+
+namespace
+{
+	const int kWidth = 800;
+	const int kHeight = 600;
+	const int kFrames = 100;
+
+	void drawFrames(Renderer& renderer, DrawList& drawList, Shader& shader, Framebuffer& target, bool batched, BenchmarkCounters& counters)
+	{
+		static const float kColor[4] = { 0.2f, 0.6f, 0.9f, 1.0f };
+		const float cellWidth = 1.6f / Board::kWidth;
+		const float cellHeight = 1.8f / Board::kVisibleHeight;
+
+		target.bind();
+		for (int frame = 0; frame < kFrames; frame++)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			renderer.resetStats();
+
+			if (batched)
+				renderer.begin(shader, RenderLayer::Pieces);
+			for (int y = 0; y < Board::kVisibleHeight; y++)
+			{
+				for (int x = 0; x < Board::kWidth; x++)
+				{
+					// Ending the batch after every quad turns each one into its own draw call
+					if (!batched)
+						renderer.begin(shader, RenderLayer::Pieces);
+					renderer.drawQuad(-0.8f + x * cellWidth, -0.9f + y * cellHeight, cellWidth * 0.9f, cellHeight * 0.9f, kColor);
+					if (!batched)
+						renderer.end();
+				}
+			}
+			renderer.end();
+			drawList.execute();
+			renderer.endFrame();
+
+			// Wait for every frame so the rate covers the GPU's share of the work too
+			glFinish();
+			counters.add("draws", renderer.getDrawCalls());
+		}
+		counters.add("frames", kFrames);
+	}
+
+	// Keeps the ring full with a fresh burst every few frames, the CPU side staying the same size throughout
+	void drawParticleFrames(ParticleSystem& particles, DrawList& drawList, Framebuffer& target, BenchmarkCounters& counters)
+	{
+		static const float kColor[4] = { 1.0f, 0.9f, 0.7f, 1.0f };
+		const unsigned int kBurst = ParticleSystem::kMaxParticles / 4;
+
+		target.bind();
+		uint64_t simulated = 0;
+		for (int frame = 0; frame < kFrames; frame++)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			if (frame % 8 == 0)
+				particles.emit(-0.5f, -0.2f, 1.0f, 0.1f, kColor, kBurst, 0.8f, 1.0f, 0.4f, 0.01f);
+
+			particles.update(1.0f / 60.0f, (float)kHeight / kWidth);
+			drawList.execute();
+			glFinish();
+			simulated += particles.getSlotCount();
+		}
+		counters.add("frames", kFrames);
+		counters.add("particles", simulated);
+	}
+}
+
+void registerRenderBenchmarks(BenchmarkRunner& runner)
+{
+	if (!glfwInit())
+	{
+		fprintf(stderr, "GLFW failed to initialize, skipping render benchmarks\n");
+		return;
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(kWidth, kHeight, "Benchmark", nullptr, nullptr);
+	if (!window)
+	{
+		fprintf(stderr, "No GL 4.3 context available, skipping render benchmarks\n");
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+	if (glewInit() != GLEW_OK)
+	{
+		fprintf(stderr, "GLEW failed to initialize, skipping render benchmarks\n");
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return;
+	}
+	printf("Renderer: %s\n", glGetString(GL_RENDERER));
+
+	{
+		Framebuffer target(kWidth, kHeight);
+		DrawList drawList;
+		Renderer renderer(drawList);
+		Shader shader(TETRIS_SHADER_DIRECTORY "/Basic.shader");
+
+		UniformBuffer frameUniforms(sizeof(FrameUniforms), UniformBuffer::kFrameBinding);
+		shader.BindUniformBlock("Frame", UniformBuffer::kFrameBinding);
+		FrameUniforms frame = {};
+		frame.projection[0] = frame.projection[5] = frame.projection[10] = frame.projection[15] = 1.0f;
+		frameUniforms.setData(&frame, sizeof(frame));
+
+		runner.run("gl.board_batched", [&](BenchmarkCounters& counters)
+		{
+			drawFrames(renderer, drawList, shader, target, true, counters);
+		});
+		runner.run("gl.board_per_quad", [&](BenchmarkCounters& counters)
+		{
+			drawFrames(renderer, drawList, shader, target, false, counters);
+		});
+
+		Shader particleUpdate(TETRIS_SHADER_DIRECTORY "/ParticleUpdate.shader");
+		Shader particleDraw(TETRIS_SHADER_DIRECTORY "/Particle.shader");
+		particleDraw.BindUniformBlock("Frame", UniformBuffer::kFrameBinding);
+		ParticleSystem particles(particleUpdate, particleDraw, drawList);
+		runner.run("gl.particles", [&](BenchmarkCounters& counters)
+		{
+			drawParticleFrames(particles, drawList, target, counters);
+		});
+	}
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+class BenchmarkRunner;
+
+// Frame rate of a full board drawn through the batch renderer, once as a single batch and once
+// with a draw call per quad. Drawn offscreen in a hidden window; skipped when there is no GL.
+void registerRenderBenchmarks(BenchmarkRunner& runner);
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "Benchmark.h"
+#include "Game/Game.h"
+#include "Game/MoveGenerator.h"
+#include "AI/PlacementSearch.h"
+#include "AI/AIPlayer.h"
+#include "AI/BatchSimulation.h"
+#include "Core/ThreadPool.h"
+#include "Core/Lz4.h"
+#include "Core/AssetArchive.h"
+#include "Rendering/QuadVertex.h"
+#include "Rendering/BoardRenderer.h"
+#ifdef TETRIS_BENCH_GL
+#include "RenderBenchmarks.h"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef TETRIS_REVISION
+#define TETRIS_REVISION "unknown"
+#endif
+
+namespace
+{
+	// Keeps results alive so the optimizer cannot drop the work that produced them
+	volatile uint64_t s_sink;
+
+	uint32_t nextRandom(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	// Heights summed over columns plus a penalty per covered hole, lower being better
+	int scoreBoard(const Board& board)
+	{
+		int score = 0;
+		uint16_t seen = 0;
+		for (int y = 0; y < Board::kHeight; y++)
+		{
+			const uint16_t cells = board.getCells(y);
+			for (uint16_t holes = seen & (uint16_t)~cells; holes; holes &= holes - 1)
+				score += 8;
+			for (uint16_t fresh = cells & (uint16_t)~seen; fresh; fresh &= fresh - 1)
+				score += Board::kHeight - y;
+			seen |= cells;
+		}
+		return score;
+	}
+
+	// Greedy single piece lookahead, just good enough to keep games going and lines clearing
+	Placement choosePlacement(const Game& game)
+	{
+		Placement placements[MoveGenerator::kMaxPlacements];
+		const ActivePiece& piece = game.getActivePiece();
+		const int count = MoveGenerator::generate(game.getBoard(), piece.type, piece.rotation, piece.x, piece.y, placements);
+
+		Placement best = { (uint8_t)piece.rotation, (int8_t)piece.x, (int8_t)piece.y };
+		int bestScore = 0x7FFFFFFF;
+		for (int i = 0; i < count; i++)
+		{
+			Board board = game.getBoard();
+			board.place(piece.type, placements[i].rotation, placements[i].x, placements[i].y);
+			const int cleared = board.clearLines();
+			const int score = scoreBoard(board) - cleared * 40;
+			if (score < bestScore)
+			{
+				bestScore = score;
+				best = placements[i];
+			}
+		}
+		return best;
+	}
+
+	// Half filled board with one gap per row, standing in for a mid game position
+	Board makeBoard(uint32_t& state)
+	{
+		Board board;
+		for (int y = Board::kHeight / 2; y < Board::kHeight; y++)
+		{
+			const int gap = (int)(nextRandom(state) % Board::kWidth);
+			for (int x = 0; x < Board::kWidth; x++)
+			{
+				if (x != gap && nextRandom(state) % 4 != 0)
+					board.place(PieceType::O, 0, x - 1, y - 1);
+			}
+		}
+		board.clearLines();
+		return board;
+	}
+
+	// Searches the same mid game position over and over, on the pool or the calling thread alone
+	void runSearchBenchmark(ThreadPool* pool, BenchmarkCounters& counters)
+	{
+		Evaluator evaluator;
+		Game game(3);
+		PlacementSearch opening(evaluator, nullptr);
+		AIPlayer player(opening);
+		while (game.getPiecesPlaced() < 40 && !game.isGameOver())
+		{
+			player.update(game);
+			game.tick();
+		}
+
+		PlacementSearch search(evaluator, pool);
+		const int kSearches = 100;
+		for (int i = 0; i < kSearches; i++)
+			s_sink = (uint64_t)search.findBest(game).score;
+		counters.add("searches", kSearches);
+		counters.add("placements", search.getEvaluatedCount());
+	}
+
+	void registerCoreBenchmarks(BenchmarkRunner& runner, ThreadPool& pool)
+	{
+		runner.run("core.game", [](BenchmarkCounters& counters)
+		{
+			// Whole games through the public game interface, restarting whenever one tops out
+			const int kPieces = 20000;
+			Game game(1);
+			int games = 0;
+			int pieces = 0;
+			int lines = 0;
+			while (pieces + game.getPiecesPlaced() < kPieces)
+			{
+				MoveGenerator::apply(game, choosePlacement(game));
+				game.tick();
+				if (game.isGameOver())
+				{
+					pieces += game.getPiecesPlaced();
+					lines += game.getLines();
+					game.reset(++games + 1);
+				}
+			}
+			pieces += game.getPiecesPlaced();
+			lines += game.getLines();
+			counters.add("pieces", pieces);
+			counters.add("lines", lines);
+		});
+
+		runner.run("core.move_generation", [](BenchmarkCounters& counters)
+		{
+			uint32_t state = 0x12345678u;
+			const Board board = makeBoard(state);
+			Placement placements[MoveGenerator::kMaxPlacements];
+			uint64_t generated = 0;
+			const int kIterations = 200000;
+			for (int i = 0; i < kIterations; i++)
+				generated += MoveGenerator::generate(board, (PieceType)(i % kPieceTypeCount), 0, Game::kSpawnX, Game::kSpawnY, placements);
+			s_sink = generated;
+			counters.add("generations", kIterations);
+			counters.add("placements", generated);
+		});
+
+		runner.run("core.collision", [](BenchmarkCounters& counters)
+		{
+			uint32_t state = 0x9E3779B9u;
+			const Board board = makeBoard(state);
+			const int kChecks = 10000000;
+			uint64_t fits = 0;
+			for (int i = 0; i < kChecks; i++)
+			{
+				const uint32_t r = nextRandom(state);
+				fits += board.fits((PieceType)(r % kPieceTypeCount), (r >> 4) & 3, (int)((r >> 8) % 13) - 3, (int)((r >> 12) % 21));
+			}
+			s_sink = fits;
+			counters.add("checks", kChecks);
+		});
+
+		runner.run("ai.search", [&pool](BenchmarkCounters& counters)
+		{
+			runSearchBenchmark(&pool, counters);
+		});
+
+		runner.run("ai.search_single_thread", [](BenchmarkCounters& counters)
+		{
+			runSearchBenchmark(nullptr, counters);
+		});
+
+		runner.run("ai.batch", [&pool](BenchmarkCounters& counters)
+		{
+			BatchSettings settings;
+			settings.gameCount = 512;
+			settings.maxPieces = 200;
+			BatchSimulation batch(settings);
+			batch.run(&pool);
+			counters.add("games", (uint64_t)settings.gameCount);
+			counters.add("pieces", batch.getTotalPieces());
+		});
+
+		runner.run("render.board_quads", [](BenchmarkCounters& counters)
+		{
+			// CPU cost of building the batched quads for every cell of a full visible field
+			static QuadVertex vertices[BoardRenderer::kCellCount * 4];
+			uint32_t state = 7;
+			const Board board = makeBoard(state);
+			const int kBoards = 20000;
+			const float cellWidth = 0.0675f;
+			const float cellHeight = 0.09f;
+			for (int i = 0; i < kBoards; i++)
+			{
+				QuadVertex* quad = vertices;
+				for (int row = 0; row < Board::kVisibleHeight; row++)
+				{
+					for (int x = 0; x < Board::kWidth; x++, quad += 4)
+					{
+						const uint8_t color = (uint8_t)board.getCellColor(x, row + Board::kHiddenRows);
+						const uint8_t rgba[4] = { (uint8_t)(color * 32), (uint8_t)(color * 16), (uint8_t)(color * 8), 255 };
+						writeQuadVertices(quad, -0.3375f + x * cellWidth, 0.9f - (row + 1) * cellHeight, cellWidth, cellHeight, rgba, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+					}
+				}
+				s_sink = s_sink + vertices[i % (BoardRenderer::kCellCount * 4)].color[0];
+			}
+			counters.add("boards", kBoards);
+		});
+
+		runner.run("render.board_instances", [](BenchmarkCounters& counters)
+		{
+			// The instanced path packs one word per cell instead
+			static uint32_t instances[BoardRenderer::kCellCount];
+			uint32_t state = 7;
+			const Board board = makeBoard(state);
+			const int kBoards = 100000;
+			for (int i = 0; i < kBoards; i++)
+			{
+				for (int row = 0; row < Board::kVisibleHeight; row++)
+					BoardRenderer::packRow(board, row, instances + row * Board::kWidth);
+				s_sink = s_sink + instances[i % BoardRenderer::kCellCount];
+			}
+			counters.add("boards", kBoards);
+		});
+
+		runner.run("assets.lz4_decompress", [](BenchmarkCounters& counters)
+		{
+			// Shader like text, repetitive enough to compress about as well as the real sources
+			const char* line = "\tgl_Position = u_Projection * vec4(a_Position.xy + u_Offset, 0.0, 1.0);\n";
+			const size_t kSize = 256 * 1024;
+			uint8_t* source = new uint8_t[kSize];
+			for (size_t i = 0, length = strlen(line); i < kSize; i++)
+				source[i] = (uint8_t)line[(i * 7 / 5) % length];
+			uint8_t* compressed = new uint8_t[lz4CompressBound(kSize)];
+			const size_t compressedSize = lz4Compress(source, kSize, compressed, lz4CompressBound(kSize));
+
+			const int kRuns = 200;
+			uint64_t bytes = 0;
+			for (int i = 0; i < kRuns; i++)
+				bytes += lz4Decompress(compressed, compressedSize, source, kSize);
+			s_sink = bytes;
+			counters.add("bytes", bytes);
+			delete[] compressed;
+			delete[] source;
+		});
+
+		runner.run("assets.archive_lookup", [](BenchmarkCounters& counters)
+		{
+			// Name lookups against a freshly written archive of a few hundred small entries
+			const int kEntries = 256;
+			char name[32];
+			AssetArchiveWriter writer;
+			for (int i = 0; i < kEntries; i++)
+			{
+				snprintf(name, sizeof(name), "res/asset%03d.bin", i);
+				writer.add(name, name, strlen(name), false);
+			}
+			const char* path = "tetris_bench.pak";
+			writer.write(path);
+			{
+				const AssetArchive archive(path);
+				const int kLookups = 200000;
+				uint64_t found = 0;
+				for (int i = 0; i < kLookups; i++)
+				{
+					snprintf(name, sizeof(name), "res/asset%03d.bin", i % kEntries);
+					found += archive.find(name) != nullptr;
+				}
+				s_sink = found;
+				counters.add("lookups", kLookups);
+			}
+			remove(path);
+		});
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// --warmup and --repetitions set how often each benchmark runs unmeasured and measured,
+	// --filter keeps only benchmarks whose name contains the text and --json writes the results
+	int warmup = 2;
+	int repetitions = 10;
+	const char* filter = nullptr;
+	const char* jsonPath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+			warmup = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+			repetitions = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			jsonPath = argv[++i];
+	}
+
+	BenchmarkRunner runner(warmup, repetitions, filter);
+	ThreadPool pool;
+	registerCoreBenchmarks(runner, pool);
+#ifdef TETRIS_BENCH_GL
+	registerRenderBenchmarks(runner);
+#endif
+	runner.printSummary();
+
+	if (jsonPath && !runner.writeJson(jsonPath, TETRIS_REVISION))
+	{
+		fprintf(stderr, "Failed to write %s\n", jsonPath);
+		return 1;
+	}
+	return 0;
+}
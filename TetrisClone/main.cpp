@@ -1,11 +1,332 @@
 #include "Rendering/Window.h"
+#include "Rendering/Font.h"
+#include "Game/Game.h"
+#include "Game/Replay.h"
+#include "Core/GameLoop.h"
+#include "Core/KeyboardInput.h"
+#include "Core/Profiler.h"
+#include "Core/ThreadPool.h"
+#include "Core/AssetArchive.h"
+#include "Core/MappedFile.h"
+#include "AI/Evaluator.h"
+#include "AI/PlacementSearch.h"
+#include "AI/AIPlayer.h"
+#include "AI/BatchSimulation.h"
+#include <ctime>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+
+namespace
+{
+	// Runs a replay through the simulation alone, as fast as it will go, and checks it ends in the recorded state
+	int runReplay(InputReplayer& replayer)
+	{
+		Game game(replayer.getSeed(), replayer.getTickRate());
+
+		const auto start = std::chrono::steady_clock::now();
+		while (!replayer.isFinished(game))
+		{
+			replayer.update(game);
+			game.tick();
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		const double gameSeconds = (double)game.getTickCount() / replayer.getTickRate();
+		printf("Replayed %llu ticks (%.1f s of play) with %llu inputs in %.3f ms, %.0fx real time\n",
+			(unsigned long long)game.getTickCount(), gameSeconds, (unsigned long long)replayer.getInputCount(),
+			elapsed.count() * 1000.0, elapsed.count() > 0.0 ? gameSeconds / elapsed.count() : 0.0);
+		printf("Score %llu, lines %d, level %d\n", (unsigned long long)game.getScore(), game.getLines(), game.getLevel());
+
+		if (!replayer.hasChecksum())
+		{
+			printf("Replay has no end marker, so the final state cannot be verified\n");
+			return 0;
+		}
+
+		const bool match = game.getChecksum() == replayer.getChecksum();
+		printf("Final state %s the recording (%016llx)\n", match ? "matches" : "DIFFERS FROM", (unsigned long long)game.getChecksum());
+		return match ? 0 : 1;
+	}
+
+	// Plays games back to back without a window, each ending on a top out or after maxPieces pieces
+	int runAIGames(PlacementSearch& search, int gameCount, int maxPieces, uint32_t seed)
+	{
+		AIPlayer player(search);
+		uint64_t pieces = 0;
+		uint64_t lines = 0;
+		int toppedOut = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < gameCount; i++)
+		{
+			Game game(seed + (uint32_t)i);
+			player.reset();
+			while (!game.isGameOver() && game.getPiecesPlaced() < maxPieces)
+			{
+				player.update(game);
+				game.tick();
+			}
+
+			pieces += game.getPiecesPlaced();
+			lines += game.getLines();
+			if (game.isGameOver())
+				toppedOut++;
+			printf("Game %d: %d pieces, %d lines, score %llu%s\n", i + 1, game.getPiecesPlaced(), game.getLines(),
+				(unsigned long long)game.getScore(), game.isGameOver() ? ", topped out" : "");
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		printf("%d games (%d topped out) in %.2f s: %.0f pieces/s, %.1f lines per game\n", gameCount, toppedOut, elapsed.count(),
+			elapsed.count() > 0.0 ? pieces / elapsed.count() : 0.0, gameCount > 0 ? (double)lines / gameCount : 0.0);
+		printf("Search depth %d: %llu placements evaluated, %.0f per ms, %.3f ms per piece\n", search.getSettings().depth,
+			(unsigned long long)search.getEvaluatedCount(),
+			search.getSearchSeconds() > 0.0 ? search.getEvaluatedCount() / (search.getSearchSeconds() * 1000.0) : 0.0,
+			search.getSearchCount() > 0 ? search.getSearchSeconds() * 1000.0 / search.getSearchCount() : 0.0);
+		return 0;
+	}
+
+	// Packs the shader sources and the baked font into one archive, LZ4 compressing what shrinks
+	int packAssets(const char* archivePath)
+	{
+		const char* shaderPaths[] = { "res/shaders/Basic.shader", "res/shaders/Cell.shader", "res/shaders/ParticleUpdate.shader",
+			"res/shaders/Particle.shader" };
+		AssetArchiveWriter writer;
+		for (const char* path : shaderPaths)
+		{
+			const MappedFile file(path);
+			if (!file.isValid())
+			{
+				printf("Failed to read %s\n", path);
+				return 1;
+			}
+			writer.add(path, file.getData(), file.getSize(), true);
+		}
+
+		uint8_t* fields = new uint8_t[Font::kFieldBytes];
+		uint8_t* packed = new uint8_t[Font::kPackedBytes];
+		Font::bakeFields(fields);
+		Font::packFields(fields, packed);
+		writer.add(Font::kArchiveName, packed, Font::kPackedBytes, true);
+		delete[] packed;
+		delete[] fields;
+
+		if (!writer.write(archivePath))
+		{
+			printf("Failed to write %s\n", archivePath);
+			return 1;
+		}
+		printf("Packed %zu assets into %s: %llu bytes stored for %llu of source\n", writer.getEntryCount(), archivePath,
+			(unsigned long long)writer.getStoredBytes(), (unsigned long long)writer.getSourceBytes());
+		return 0;
+	}
+}
 
 int main(int argc, char* argv[])
 {
-	Window* window = new Window("Tetris Clone", 800, 600);
-	while (!window->windowShouldClose())
+	GameLoopSettings settings;
+	settings.tickRate = 60;
+
+	// --headless renders offscreen one tick per frame, --frames stops after that many frames,
+	// --capture writes each frame into a directory, --seed fixes the piece sequence and --profile
+	// records timings, shows the frame time overlay and writes a trace on exit.
+	// --record writes the inputs of the game to a replay file. --replay plays one back, on its own
+	// as fast as possible, or rendered frame by frame when combined with --headless.
+	// --ai lets the computer play, searching --ai-depth pieces ahead on --threads threads (0 for all).
+	// --ai-games plays that many games back to back without a window, each capped at --ai-pieces.
+	// --batch plays that many games at once with the one piece evaluator, each capped at --batch-pieces,
+	// and writes per game results to --batch-csv and the score, line and length distributions to --batch-json.
+	// --pack writes the game's assets into an archive and exits, and --archive loads them from one.
+	// --das and --arr set the auto shift delay and repeat rate in milliseconds, --late-latch applies input
+	// arriving during the ticks to the frame being drawn and --latency reports input latency on exit.
+	// --internal-height draws the playfield that many pixels high and scales it up to the window.
+	bool headless = false;
+	const char* captureDirectory = nullptr;
+	uint32_t seed = (uint32_t)time(nullptr);
+	bool profile = false;
+	const char* recordPath = nullptr;
+	const char* replayPath = nullptr;
+	bool ai = false;
+	int aiGames = 0;
+	int aiPieces = 10000;
+	SearchSettings searchSettings;
+	int threads = 0;
+	BatchSettings batchSettings;
+	batchSettings.gameCount = 0;
+	const char* batchCsvPath = nullptr;
+	const char* batchJsonPath = nullptr;
+	const char* packPath = nullptr;
+	const char* archivePath = nullptr;
+	AutoRepeatSettings autoRepeat;
+	bool measureLatency = false;
+	int internalHeight = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+			headless = true;
+		else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			settings.maxFrames = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+			captureDirectory = argv[++i];
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--profile") == 0)
+			profile = true;
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (strcmp(argv[i], "--ai") == 0)
+			ai = true;
+		else if (strcmp(argv[i], "--ai-games") == 0 && i + 1 < argc)
+			aiGames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--ai-pieces") == 0 && i + 1 < argc)
+			aiPieces = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--ai-depth") == 0 && i + 1 < argc)
+			searchSettings.depth = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+			batchSettings.gameCount = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--batch-pieces") == 0 && i + 1 < argc)
+			batchSettings.maxPieces = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--batch-csv") == 0 && i + 1 < argc)
+			batchCsvPath = argv[++i];
+		else if (strcmp(argv[i], "--batch-json") == 0 && i + 1 < argc)
+			batchJsonPath = argv[++i];
+		else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+			packPath = argv[++i];
+		else if (strcmp(argv[i], "--archive") == 0 && i + 1 < argc)
+			archivePath = argv[++i];
+		else if (strcmp(argv[i], "--das") == 0 && i + 1 < argc)
+			autoRepeat.delayNanos = (uint64_t)(atof(argv[++i]) * 1000000.0);
+		else if (strcmp(argv[i], "--arr") == 0 && i + 1 < argc)
+			autoRepeat.rateNanos = (uint64_t)(atof(argv[++i]) * 1000000.0);
+		else if (strcmp(argv[i], "--late-latch") == 0)
+			settings.lateLatch = true;
+		else if (strcmp(argv[i], "--latency") == 0)
+			measureLatency = true;
+		else if (strcmp(argv[i], "--internal-height") == 0 && i + 1 < argc)
+			internalHeight = atoi(argv[++i]);
+	}
+
+	if (packPath)
+		return packAssets(packPath);
+
+	if (batchSettings.gameCount > 0)
 	{
-		window->update();
+		batchSettings.seed = seed;
+		ThreadPool batchPool(threads);
+		BatchSimulation batch(batchSettings);
+		batch.run(&batchPool);
+		batch.printSummary();
+
+		bool written = true;
+		if (batchCsvPath)
+			written &= batch.writeCsv(batchCsvPath);
+		if (batchJsonPath)
+			written &= batch.writeJson(batchJsonPath);
+		if (!written)
+			printf("Failed to write the batch results\n");
+		return written ? 0 : 1;
 	}
+
+	InputReplayer* replayer = nullptr;
+	if (replayPath)
+	{
+		replayer = new InputReplayer(replayPath);
+		if (!replayer->isValid())
+		{
+			delete replayer;
+			return 1;
+		}
+
+		if (!headless)
+		{
+			const int result = runReplay(*replayer);
+			delete replayer;
+			return result;
+		}
+
+		seed = replayer->getSeed();
+		settings.tickRate = replayer->getTickRate();
+	}
+
+	Evaluator evaluator;
+	ThreadPool* pool = nullptr;
+	PlacementSearch* search = nullptr;
+	if (ai || aiGames > 0)
+	{
+		pool = new ThreadPool(threads);
+		search = new PlacementSearch(evaluator, pool, searchSettings);
+	}
+
+	if (aiGames > 0)
+	{
+		const int result = runAIGames(*search, aiGames, aiPieces, seed);
+		delete search;
+		delete pool;
+		delete replayer;
+		return result;
+	}
+
+	if (headless)
+	{
+		settings.vsync = false;
+		settings.lockstep = true;
+	}
+
+	Profiler::setEnabled(profile);
+
+	Window* window = new Window("Tetris Clone", 800, 600, headless, archivePath);
+	if (captureDirectory)
+		window->setCaptureDirectory(captureDirectory);
+	window->setInternalHeight(internalHeight);
+
+	Game game(seed, settings.tickRate);
+
+	InputRecorder* recorder = nullptr;
+	KeyboardInput keyboard;
+	keyboard.setAutoRepeat(autoRepeat);
+	keyboard.setMeasureLatency(measureLatency);
+	if (recordPath && !replayer)
+	{
+		recorder = new InputRecorder(recordPath, seed, settings.tickRate);
+		keyboard.setRecorder(recorder);
+	}
+	window->setKeyboardInput(&keyboard);
+
+	AIPlayer* player = search ? new AIPlayer(*search) : nullptr;
+
+	GameLoop loop(*window, game, settings);
+	if (replayer)
+		loop.setInputSource(replayer);
+	else if (player)
+		loop.setInputSource(player);
+	else
+		loop.setInputSource(&keyboard);
+	loop.run();
+
+	if (measureLatency)
+		keyboard.printLatencySummary();
+
+	if (recorder)
+	{
+		recorder->finish(game);
+		delete recorder;
+	}
+	delete replayer;
+	delete player;
+	delete search;
+	delete pool;
+
+	if (profile)
+	{
+		Profiler::printSummary();
+		Profiler::writeChromeTrace("profile.json");
+	}
+
+	delete window;
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "AIPlayer.h"
+#include "PlacementSearch.h"
+#include "Game/Game.h"
+
+AIPlayer::AIPlayer(PlacementSearch& search)
+	: m_search(search)
+{
+	reset();
+}
+
+void AIPlayer::reset()
+{
+	m_pathLength = 0;
+	m_pathIndex = 0;
+	m_plannedPiece = -1;
+	m_softDropping = false;
+}
+
+void AIPlayer::update(Game& game)
+{
+	if (game.isGameOver())
+		return;
+
+	if (m_plannedPiece != game.getPiecesPlaced())
+		plan(game);
+
+	const ActivePiece& piece = game.getActivePiece();
+	while (m_pathIndex < m_pathLength)
+	{
+		const InputAction action = m_path[m_pathIndex];
+		if (action != InputAction::SoftDropOn)
+		{
+			game.apply(action);
+			m_pathIndex++;
+			continue;
+		}
+
+		// Keep soft dropping over the following ticks until the piece lands
+		if (game.getBoard().fits(piece.type, piece.rotation, piece.x, piece.y + 1))
+		{
+			if (!m_softDropping)
+			{
+				game.apply(InputAction::SoftDropOn);
+				m_softDropping = true;
+			}
+			return;
+		}
+
+		if (m_softDropping)
+		{
+			game.apply(InputAction::SoftDropOff);
+			m_softDropping = false;
+		}
+		m_pathIndex++;
+	}
+
+	game.apply(InputAction::HardDrop);
+}
+
+void AIPlayer::plan(Game& game)
+{
+	m_plannedPiece = game.getPiecesPlaced();
+	m_pathLength = 0;
+	m_pathIndex = 0;
+	if (m_softDropping)
+	{
+		game.apply(InputAction::SoftDropOff);
+		m_softDropping = false;
+	}
+
+	const SearchResult result = m_search.findBest(game);
+	if (!result.found)
+		return;
+
+	if (result.hold)
+		game.apply(InputAction::Hold);
+
+	const ActivePiece& piece = game.getActivePiece();
+	const int length = MoveGenerator::findPath(game.getBoard(), piece.type, piece.rotation, piece.x, piece.y, result.placement, m_path);
+	m_pathLength = length > 0 ? length : 0;
+}
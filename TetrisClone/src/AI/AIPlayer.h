@@ -0,0 +1,28 @@
+#pragma once
+#include "Game/Input.h"
+#include "Game/MoveGenerator.h"
+
+class PlacementSearch;
+
+// Plays a game through the same actions as a keyboard. Every new piece is searched for the best
+// placement, then the moves to it are issued, with soft drops held across ticks until the piece lands.
+class AIPlayer : public InputSource
+{
+public:
+	explicit AIPlayer(PlacementSearch& search);
+
+	void update(Game& game) override;
+	// Forgets the current plan, for starting over on a fresh game
+	void reset();
+
+private:
+	void plan(Game& game);
+
+private:
+	PlacementSearch& m_search;
+	InputAction m_path[MoveGenerator::kMaxPathLength];
+	int m_pathLength;
+	int m_pathIndex;
+	int m_plannedPiece;
+	bool m_softDropping;
+};
\ No newline at end of file
@@ -0,0 +1,474 @@
+#include "BatchSimulation.h"
+#include "Game/Game.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	constexpr int kLoss = -0x3FFFFFFF;
+	// Rows past the bottom are solid, as on Board
+	constexpr int kBoardRows = Board::kHeight + 4;
+
+	// Bit count of a row by halves, written out so it vectorizes where a popcount instruction would not
+	inline int countRowBits(uint32_t bits)
+	{
+		bits = bits - ((bits >> 1) & 0x5555);
+		bits = (bits & 0x3333) + ((bits >> 2) & 0x3333);
+		bits = (bits + (bits >> 4)) & 0x0F0F;
+		return (int)((bits + (bits >> 8)) & 0x1F);
+	}
+
+	struct Distribution
+	{
+		double mean;
+		double stddev;
+		double min;
+		double p10;
+		double p50;
+		double p90;
+		double max;
+	};
+
+	Distribution getDistribution(std::vector<double> values)
+	{
+		Distribution result = {};
+		if (values.empty())
+			return result;
+
+		std::sort(values.begin(), values.end());
+		double sum = 0.0;
+		for (double value : values)
+			sum += value;
+		result.mean = sum / values.size();
+
+		double variance = 0.0;
+		for (double value : values)
+			variance += (value - result.mean) * (value - result.mean);
+		result.stddev = std::sqrt(variance / values.size());
+
+		auto percentile = [&values](double p) { return values[(size_t)(p * (values.size() - 1) + 0.5)]; };
+		result.min = values.front();
+		result.p10 = percentile(0.1);
+		result.p50 = percentile(0.5);
+		result.p90 = percentile(0.9);
+		result.max = values.back();
+		return result;
+	}
+
+	struct Summary
+	{
+		std::vector<double> scores;
+		Distribution score;
+		Distribution lines;
+		Distribution pieces;
+		int toppedOut;
+	};
+
+	Summary summarize(const uint64_t* scores, const int32_t* lines, const int32_t* pieces, const uint8_t* toppedOut, int games)
+	{
+		Summary summary;
+		std::vector<double> lineCounts, pieceCounts;
+		summary.toppedOut = 0;
+		for (int g = 0; g < games; g++)
+		{
+			summary.scores.push_back((double)scores[g]);
+			lineCounts.push_back(lines[g]);
+			pieceCounts.push_back(pieces[g]);
+			summary.toppedOut += toppedOut[g];
+		}
+
+		summary.score = getDistribution(summary.scores);
+		summary.lines = getDistribution(lineCounts);
+		summary.pieces = getDistribution(pieceCounts);
+		return summary;
+	}
+
+	void writeDistribution(std::ofstream& file, const char* name, const Distribution& d)
+	{
+		file << "\"" << name << "\":{\"mean\":" << d.mean << ",\"stddev\":" << d.stddev << ",\"min\":" << d.min
+			<< ",\"p10\":" << d.p10 << ",\"p50\":" << d.p50 << ",\"p90\":" << d.p90 << ",\"max\":" << d.max << "}";
+	}
+}
+
+BatchSimulation::BatchSimulation(const BatchSettings& settings)
+	: m_settings(settings), m_evaluator(settings.weights), m_seconds(0.0)
+{
+	if (m_settings.gameCount < 1)
+		m_settings.gameCount = 1;
+
+	const int games = m_settings.gameCount;
+	m_rows = new uint16_t[kBoardRows * games];
+	m_pieceType = new uint8_t[games];
+	m_alive = new uint8_t[games];
+	m_toppedOut = new uint8_t[games];
+	m_score = new uint64_t[games];
+	m_lines = new int32_t[games];
+	m_pieces = new int32_t[games];
+	m_randomizers = new Randomizer[games];
+	reset();
+}
+
+BatchSimulation::~BatchSimulation()
+{
+	delete[] m_rows;
+	delete[] m_pieceType;
+	delete[] m_alive;
+	delete[] m_toppedOut;
+	delete[] m_score;
+	delete[] m_lines;
+	delete[] m_pieces;
+	delete[] m_randomizers;
+}
+
+void BatchSimulation::reset()
+{
+	const int games = m_settings.gameCount;
+	for (int y = 0; y < kBoardRows; y++)
+	{
+		const uint16_t row = y < Board::kHeight ? Board::kEmptyRow : Board::kFullRow;
+		std::fill(m_rows + y * games, m_rows + (y + 1) * games, row);
+	}
+
+	for (int g = 0; g < games; g++)
+	{
+		m_randomizers[g].reset(m_settings.seed + (uint32_t)g);
+		m_pieceType[g] = (uint8_t)m_randomizers[g].next();
+		m_alive[g] = 1;
+		m_toppedOut[g] = 0;
+		m_score[g] = 0;
+		m_lines[g] = 0;
+		m_pieces[g] = 0;
+	}
+}
+
+void BatchSimulation::run(ThreadPool* pool)
+{
+	reset();
+	const auto start = std::chrono::steady_clock::now();
+
+	const int shardCount = (m_settings.gameCount + kLanesPerShard - 1) / kLanesPerShard;
+	auto shardJob = [this](int shard)
+	{
+		const int begin = shard * kLanesPerShard;
+		runShard(begin, std::min(begin + kLanesPerShard, m_settings.gameCount));
+	};
+	if (pool)
+		pool->parallelFor(shardCount, shardJob);
+	else
+	{
+		for (int i = 0; i < shardCount; i++)
+			shardJob(i);
+	}
+
+	m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BatchSimulation::runShard(int begin, int end)
+{
+	const int count = end - begin;
+	const int stride = m_settings.gameCount;
+	int bestScore[kLanesPerShard];
+	int8_t bestRotation[kLanesPerShard];
+	int8_t bestX[kLanesPerShard];
+	int8_t bestY[kLanesPerShard];
+
+	int alive = count;
+	while (alive > 0)
+	{
+		chooseDrops(begin, count, bestScore, bestRotation, bestX, bestY);
+
+		alive = 0;
+		for (int l = 0; l < count; l++)
+		{
+			const int game = begin + l;
+			if (!m_alive[game])
+				continue;
+
+			if (bestScore[l] == kLoss)
+			{
+				m_alive[game] = 0;
+				m_toppedOut[game] = 1;
+				continue;
+			}
+
+			const int level = m_lines[game] / 10 + 1;
+			const int cleared = lockPiece(game, bestRotation[l], bestX[l], bestY[l]);
+			m_score[game] += (uint64_t)Game::kLineScores[cleared] * level + 2 * (uint64_t)(bestY[l] - Game::kSpawnY);
+			m_lines[game] += cleared;
+			m_pieces[game]++;
+
+			const PieceType next = m_randomizers[game].next();
+			m_pieceType[game] = (uint8_t)next;
+			if (m_pieces[game] >= m_settings.maxPieces)
+			{
+				m_alive[game] = 0;
+				continue;
+			}
+
+			// Blocked spawn ends the game, as in Game::spawn
+			const PieceMask& mask = getPieceMask(next, 0);
+			uint16_t hit = 0;
+			for (int r = mask.minY; r <= mask.maxY; r++)
+				hit |= m_rows[(Game::kSpawnY + r) * stride + game] & Board::shiftMask(mask.rows[r], Game::kSpawnX);
+			if (hit)
+			{
+				m_alive[game] = 0;
+				m_toppedOut[game] = 1;
+				continue;
+			}
+			alive++;
+		}
+	}
+}
+
+void BatchSimulation::chooseDrops(int begin, int count, int* bestScore, int8_t* bestRotation, int8_t* bestX, int8_t* bestY) const
+{
+	// Every loop over l below runs the same operations on each game's row y, which sit next to each
+	// other in memory, so they compile to SIMD across games. Per game differences are selects.
+	const int stride = m_settings.gameCount;
+	const uint16_t* rows = m_rows + begin;
+	const uint8_t* types = m_pieceType + begin;
+	const uint8_t* aliveGames = m_alive + begin;
+	const EvaluatorWeights& weights = m_evaluator.getWeights();
+
+	uint16_t masks[4][kLanesPerShard];
+	int16_t maxY[kLanesPerShard];
+	int16_t landY[kLanesPerShard];
+	uint8_t valid[kLanesPerShard];
+	// Column heights with a full height wall column on either side
+	int16_t heights[Board::kWidth + 2][kLanesPerShard];
+	int16_t height[kLanesPerShard];
+	int16_t filled[kLanesPerShard];
+	int16_t cleared[kLanesPerShard];
+
+	for (int l = 0; l < count; l++)
+		bestScore[l] = kLoss;
+
+	for (int rotation = 0; rotation < kRotationCount; rotation++)
+	{
+		for (int x = -Board::kWallBits; x < Board::kWidth; x++)
+		{
+			// Pieces differ per game, so the masks are looked up per lane. Columns past the
+			// edge for a piece run into the wall bits and fail the spawn check.
+			for (int l = 0; l < count; l++)
+			{
+				const PieceMask& mask = getPieceMask((PieceType)types[l], rotation);
+				for (int k = 0; k < 4; k++)
+					masks[k][l] = Board::shiftMask(mask.rows[k], x);
+				maxY[l] = mask.maxY;
+				landY[l] = Game::kSpawnY;
+			}
+
+			const uint16_t* spawn = rows + Game::kSpawnY * stride;
+			for (int l = 0; l < count; l++)
+			{
+				const uint16_t hit = (spawn[l] & masks[0][l]) | (spawn[l + stride] & masks[1][l])
+					| (spawn[l + 2 * stride] & masks[2][l]) | (spawn[l + 3 * stride] & masks[3][l]);
+				valid[l] = hit == 0 && aliveGames[l];
+			}
+
+			// Drop every game one row at a time, stopping once none of them moved
+			for (int y = Game::kSpawnY; y < Board::kHeight; y++)
+			{
+				const uint16_t* below = rows + (y + 1) * stride;
+				int moved = 0;
+				for (int l = 0; l < count; l++)
+				{
+					const uint16_t hit = (below[l] & masks[0][l]) | (below[l + stride] & masks[1][l])
+						| (below[l + 2 * stride] & masks[2][l]) | (below[l + 3 * stride] & masks[3][l]);
+					const int falling = valid[l] & (landY[l] == y) & (hit == 0);
+					landY[l] = falling ? (int16_t)(y + 1) : landY[l];
+					moved |= falling;
+				}
+				if (!moved)
+					break;
+			}
+
+			// Features of the board with the piece placed and full rows removed, counted bottom up so
+			// a column's height is the number of kept rows up to its top cell
+			for (int l = 0; l < count; l++)
+			{
+				height[l] = 0;
+				filled[l] = 0;
+				cleared[l] = 0;
+				for (int c = 1; c <= Board::kWidth; c++)
+					heights[c][l] = 0;
+				heights[0][l] = Board::kHeight;
+				heights[Board::kWidth + 1][l] = Board::kHeight;
+			}
+
+			for (int y = Board::kHeight - 1; y >= 0; y--)
+			{
+				const uint16_t* row = rows + y * stride;
+				for (int l = 0; l < count; l++)
+				{
+					// Loads are unconditional and combined with masks so the loop needs no branches
+					const int k = y - landY[l];
+					const uint16_t piece = (uint16_t)((masks[0][l] & -(uint16_t)(k == 0)) | (masks[1][l] & -(uint16_t)(k == 1))
+						| (masks[2][l] & -(uint16_t)(k == 2)) | (masks[3][l] & -(uint16_t)(k == 3)));
+					const uint16_t cells = row[l] | piece;
+					const int kept = cells != Board::kFullRow;
+					const uint16_t counted = kept ? (uint16_t)(cells & Board::kCellMask) : 0;
+					cleared[l] += (int16_t)(1 - kept);
+					height[l] += (int16_t)kept;
+					filled[l] += (int16_t)countRowBits(counted);
+					for (int c = 0; c < Board::kWidth; c++)
+						heights[c + 1][l] = (counted >> (c + Board::kWallBits)) & 1 ? height[l] : heights[c + 1][l];
+				}
+			}
+
+			for (int l = 0; l < count; l++)
+			{
+				int aggregate = 0;
+				int bumpiness = 0;
+				int wells = 0;
+				for (int c = 1; c <= Board::kWidth; c++)
+				{
+					const int h = heights[c][l];
+					const int left = heights[c - 1][l];
+					const int right = heights[c + 1][l];
+					const int depth = (left < right ? left : right) - h;
+					aggregate += h;
+					wells += depth > 0 ? depth * (depth + 1) / 2 : 0;
+				}
+				for (int c = 2; c <= Board::kWidth; c++)
+				{
+					const int step = heights[c][l] - heights[c - 1][l];
+					bumpiness += step > 0 ? step : -step;
+				}
+
+				int score = aggregate * weights.aggregateHeight + (aggregate - filled[l]) * weights.holes
+					+ bumpiness * weights.bumpiness + wells * weights.wells + cleared[l] * weights.linesCleared;
+				const int lockedOut = landY[l] + maxY[l] < Board::kHiddenRows;
+				score = valid[l] & !lockedOut ? score : kLoss;
+
+				// Strictly better only, so ties keep the first drop tried
+				const bool better = score > bestScore[l];
+				bestScore[l] = better ? score : bestScore[l];
+				bestRotation[l] = better ? (int8_t)rotation : bestRotation[l];
+				bestX[l] = better ? (int8_t)x : bestX[l];
+				bestY[l] = better ? (int8_t)landY[l] : bestY[l];
+			}
+		}
+	}
+}
+
+int BatchSimulation::lockPiece(int game, int rotation, int x, int y)
+{
+	const int stride = m_settings.gameCount;
+	uint16_t* rows = m_rows + game;
+	const PieceMask& mask = getPieceMask((PieceType)m_pieceType[game], rotation);
+
+	bool anyFull = false;
+	for (int r = mask.minY; r <= mask.maxY; r++)
+	{
+		rows[(y + r) * stride] |= Board::shiftMask(mask.rows[r], x);
+		anyFull |= rows[(y + r) * stride] == Board::kFullRow;
+	}
+	if (!anyFull)
+		return 0;
+
+	// Same compaction as Board::clearLines, striding over this game's rows
+	int cleared = 0;
+	int write = Board::kHeight - 1;
+	for (int read = Board::kHeight - 1; read >= 0; read--)
+	{
+		const uint16_t row = rows[read * stride];
+		if (row == Board::kFullRow)
+		{
+			cleared++;
+			continue;
+		}
+		rows[write * stride] = row;
+		write--;
+	}
+	for (; write >= 0; write--)
+		rows[write * stride] = Board::kEmptyRow;
+	return cleared;
+}
+
+BatchGameResult BatchSimulation::getResult(int game) const
+{
+	return { m_settings.seed + (uint32_t)game, m_score[game], m_lines[game], m_pieces[game], m_toppedOut[game] != 0 };
+}
+
+uint64_t BatchSimulation::getTotalPieces() const
+{
+	uint64_t pieces = 0;
+	for (int g = 0; g < m_settings.gameCount; g++)
+		pieces += (uint64_t)m_pieces[g];
+	return pieces;
+}
+
+bool BatchSimulation::writeCsv(const char* filePath) const
+{
+	std::ofstream file(filePath);
+	if (!file)
+		return false;
+
+	file << "game,seed,score,lines,pieces,topped_out\n";
+	for (int g = 0; g < m_settings.gameCount; g++)
+	{
+		const BatchGameResult result = getResult(g);
+		file << g << "," << result.seed << "," << result.score << "," << result.lines << "," << result.pieces << ","
+			<< (result.toppedOut ? 1 : 0) << "\n";
+	}
+	return true;
+}
+
+bool BatchSimulation::writeJson(const char* filePath) const
+{
+	std::ofstream file(filePath);
+	if (!file)
+		return false;
+
+	const Summary summary = summarize(m_score, m_lines, m_pieces, m_toppedOut, m_settings.gameCount);
+	const Distribution& scoreStats = summary.score;
+	const EvaluatorWeights& weights = m_evaluator.getWeights();
+	file << "{\"games\":" << m_settings.gameCount << ",\"maxPieces\":" << m_settings.maxPieces << ",\"seed\":" << m_settings.seed
+		<< ",\"toppedOut\":" << summary.toppedOut << ",\"seconds\":" << m_seconds
+		<< ",\"piecesPerSecond\":" << (m_seconds > 0.0 ? getTotalPieces() / m_seconds : 0.0)
+		<< ",\n\"weights\":{\"linesCleared\":" << weights.linesCleared << ",\"aggregateHeight\":" << weights.aggregateHeight
+		<< ",\"holes\":" << weights.holes << ",\"bumpiness\":" << weights.bumpiness << ",\"wells\":" << weights.wells << "},\n";
+	writeDistribution(file, "score", scoreStats);
+	file << ",\n";
+	writeDistribution(file, "lines", summary.lines);
+	file << ",\n";
+	writeDistribution(file, "pieces", summary.pieces);
+
+	// Equal width buckets from the lowest to the highest score
+	int buckets[kHistogramBuckets] = {};
+	const double range = scoreStats.max - scoreStats.min;
+	for (double score : summary.scores)
+	{
+		const int bucket = range > 0.0 ? (int)((score - scoreStats.min) / range * kHistogramBuckets) : 0;
+		buckets[bucket < kHistogramBuckets ? bucket : kHistogramBuckets - 1]++;
+	}
+
+	file << ",\n\"scoreHistogram\":[";
+	for (int i = 0; i < kHistogramBuckets; i++)
+	{
+		file << (i ? "," : "") << "{\"from\":" << scoreStats.min + range * i / kHistogramBuckets
+			<< ",\"to\":" << scoreStats.min + range * (i + 1) / kHistogramBuckets << ",\"count\":" << buckets[i] << "}";
+	}
+	file << "]}\n";
+	return true;
+}
+
+void BatchSimulation::printSummary() const
+{
+	const Summary summary = summarize(m_score, m_lines, m_pieces, m_toppedOut, m_settings.gameCount);
+	const Distribution& score = summary.score;
+	const Distribution& line = summary.lines;
+	const Distribution& piece = summary.pieces;
+	printf("%d games in %.2f s, %.0f pieces/s, %d topped out before %d pieces\n", m_settings.gameCount, m_seconds,
+		m_seconds > 0.0 ? getTotalPieces() / m_seconds : 0.0, summary.toppedOut, m_settings.maxPieces);
+	printf("Score  mean %.0f  p10 %.0f  p50 %.0f  p90 %.0f  max %.0f\n", score.mean, score.p10, score.p50, score.p90, score.max);
+	printf("Lines  mean %.1f  p10 %.0f  p50 %.0f  p90 %.0f  max %.0f\n", line.mean, line.p10, line.p50, line.p90, line.max);
+	printf("Pieces mean %.1f  p10 %.0f  p50 %.0f  p90 %.0f  max %.0f\n", piece.mean, piece.p10, piece.p50, piece.p90, piece.max);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include "Evaluator.h"
+#include "Game/Randomizer.h"
+
+class ThreadPool;
+
+struct BatchSettings
+{
+	int gameCount = 1024;
+	// Games still going after this many pieces are stopped and counted as survivors
+	int maxPieces = 1000;
+	// Game i plays the piece sequence of seed + i, the same one Game would deal
+	uint32_t seed = 1;
+	EvaluatorWeights weights;
+};
+
+struct BatchGameResult
+{
+	uint32_t seed;
+	uint64_t score;
+	int lines;
+	int pieces;
+	bool toppedOut;
+};
+
+// Plays many games at once with a one piece greedy policy, for comparing evaluator weights.
+// Boards are stored structure of arrays, row y of game g at rows[y * gameCount + g], so the drop,
+// evaluation and line clear checks run as plain loops across games that the compiler vectorizes.
+// Games are split into shards of kLanesPerShard, each shard playing to the end as one pool job.
+// Pieces are hard dropped straight down from the spawn row, without holds, tucks or gravity timing.
+class BatchSimulation
+{
+public:
+	static constexpr int kLanesPerShard = 128;
+	static constexpr int kHistogramBuckets = 20;
+
+	explicit BatchSimulation(const BatchSettings& settings);
+	~BatchSimulation();
+
+	BatchSimulation(const BatchSimulation&) = delete;
+	BatchSimulation& operator=(const BatchSimulation&) = delete;
+
+	// Plays every game to the end, on the calling thread alone when there is no pool
+	void run(ThreadPool* pool);
+
+	inline int getGameCount() const { return m_settings.gameCount; }
+	BatchGameResult getResult(int game) const;
+	inline double getSeconds() const { return m_seconds; }
+	uint64_t getTotalPieces() const;
+
+	// One line per game
+	bool writeCsv(const char* filePath) const;
+	// Distribution of score, lines and game length with percentiles and a score histogram
+	bool writeJson(const char* filePath) const;
+	void printSummary() const;
+
+private:
+	void reset();
+	void runShard(int begin, int end);
+	void chooseDrops(int begin, int count, int* bestScore, int8_t* bestRotation, int8_t* bestX, int8_t* bestY) const;
+	int lockPiece(int game, int rotation, int x, int y);
+
+private:
+	BatchSettings m_settings;
+	Evaluator m_evaluator;
+
+	uint16_t* m_rows;
+	uint8_t* m_pieceType;
+	uint8_t* m_alive;
+	uint8_t* m_toppedOut;
+	uint64_t* m_score;
+	int32_t* m_lines;
+	int32_t* m_pieces;
+	Randomizer* m_randomizers;
+
+	double m_seconds;
+};
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "Evaluator.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	inline int countBits(uint32_t bits)
+	{
+#ifdef _MSC_VER
+		return (int)__popcnt(bits);
+#else
+		return __builtin_popcount(bits);
+#endif
+	}
+
+	inline int lowestBit(uint32_t bits)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return (int)index;
+#else
+		return __builtin_ctz(bits);
+#endif
+	}
+}
+
+BoardFeatures Evaluator::getFeatures(const Board& board)
+{
+	// One pass from the top: the first filled cell met in a column sets its height,
+	// and every empty cell below a filled one is a hole
+	int heights[Board::kWidth] = {};
+	int holes = 0;
+	uint32_t seen = 0;
+	for (int y = 0; y < Board::kHeight; y++)
+	{
+		const uint32_t cells = board.getCells(y);
+		holes += countBits(seen & ~cells);
+		for (uint32_t fresh = cells & ~seen; fresh; fresh &= fresh - 1)
+			heights[lowestBit(fresh)] = Board::kHeight - y;
+		seen |= cells;
+	}
+
+	BoardFeatures features = { 0, holes, 0, 0 };
+	for (int x = 0; x < Board::kWidth; x++)
+	{
+		features.aggregateHeight += heights[x];
+		if (x > 0)
+			features.bumpiness += heights[x] > heights[x - 1] ? heights[x] - heights[x - 1] : heights[x - 1] - heights[x];
+
+		// The walls count as full height on either side
+		const int left = x > 0 ? heights[x - 1] : Board::kHeight;
+		const int right = x < Board::kWidth - 1 ? heights[x + 1] : Board::kHeight;
+		const int depth = (left < right ? left : right) - heights[x];
+		if (depth > 0)
+			features.wells += depth * (depth + 1) / 2;
+	}
+	return features;
+}
+
+int Evaluator::evaluate(const Board& board) const
+{
+	const BoardFeatures features = getFeatures(board);
+	return features.aggregateHeight * m_weights.aggregateHeight
+		+ features.holes * m_weights.holes
+		+ features.bumpiness * m_weights.bumpiness
+		+ features.wells * m_weights.wells;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include "Game/Board.h"
+
+// Integer feature weights, higher scores being better. Defaults follow the well known
+// height, lines, holes and bumpiness tuning, with a small extra cost for deep wells.
+struct EvaluatorWeights
+{
+	int linesCleared = 760;
+	int aggregateHeight = -510;
+	int holes = -356;
+	int bumpiness = -184;
+	int wells = -40;
+};
+
+struct BoardFeatures
+{
+	int aggregateHeight;
+	int holes;
+	int bumpiness;
+	// Each well contributes 1 + 2 + .. + depth, so one deep well costs more than several shallow ones
+	int wells;
+};
+
+// Scores boards from their column heights, holes, bumpiness and wells
+class Evaluator
+{
+public:
+	explicit Evaluator(const EvaluatorWeights& weights = EvaluatorWeights()) : m_weights(weights) {}
+
+	static BoardFeatures getFeatures(const Board& board);
+
+	int evaluate(const Board& board) const;
+	inline int scoreLines(int lines) const { return lines * m_weights.linesCleared; }
+
+	inline const EvaluatorWeights& getWeights() const { return m_weights; }
+
+private:
+	EvaluatorWeights m_weights;
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "PlacementSearch.h"
+#include "Core/ThreadPool.h"
+#include "Core/Profiler.h"
+#include <chrono>
+
+namespace
+{
+	constexpr int kLoss = -0x3FFFFFFF;
+}
+
+PlacementSearch::PlacementSearch(const Evaluator& evaluator, ThreadPool* pool, const SearchSettings& settings)
+	: m_evaluator(evaluator), m_pool(pool), m_settings(settings), m_evaluated(0), m_searchSeconds(0.0), m_searchCount(0)
+{
+	if (m_settings.depth < 1)
+		m_settings.depth = 1;
+	if (m_settings.depth > kMaxDepth)
+		m_settings.depth = kMaxDepth;
+}
+
+SearchResult PlacementSearch::findBest(const Game& game)
+{
+	PROFILE_SCOPE("PlacementSearch::findBest");
+	const auto start = std::chrono::steady_clock::now();
+
+	SearchResult result = {};
+	result.score = kLoss;
+	if (game.isGameOver())
+		return result;
+
+	const Board& board = game.getBoard();
+	const ActivePiece& piece = game.getActivePiece();
+
+	// Branch 0 plays the active piece, branch 1 holds it and plays the held piece, or the next one when nothing is held yet
+	int rootCount = 0;
+	for (int branch = 0; branch < 2; branch++)
+	{
+		m_pieceCount[branch] = 0;
+		if (branch == 1 && (!m_settings.allowHold || !game.canHold()))
+			continue;
+
+		int preview = 0;
+		PieceType rootType = piece.type;
+		if (branch == 1)
+			rootType = game.getHeldPiece() != PieceType::None ? game.getHeldPiece() : game.getPreview(preview++);
+		if (branch == 1 && rootType == piece.type)
+			continue;
+
+		m_pieces[branch][m_pieceCount[branch]++] = rootType;
+		while (m_pieceCount[branch] < m_settings.depth && preview < Game::kPreviewCount)
+			m_pieces[branch][m_pieceCount[branch]++] = game.getPreview(preview++);
+
+		Placement placements[MoveGenerator::kMaxPlacements];
+		const int count = branch == 0
+			? MoveGenerator::generate(board, piece.type, piece.rotation, piece.x, piece.y, placements)
+			: MoveGenerator::generate(board, rootType, 0, Game::kSpawnX, Game::kSpawnY, placements);
+		for (int i = 0; i < count; i++)
+			m_roots[rootCount++] = { branch == 1, placements[i] };
+	}
+
+	auto searchJob = [this, &board](int index)
+	{
+		m_rootEvaluated[index] = 0;
+		m_scores[index] = searchRoot(board, m_roots[index], m_rootEvaluated[index]);
+	};
+	if (m_pool)
+		m_pool->parallelFor(rootCount, searchJob);
+	else
+	{
+		for (int i = 0; i < rootCount; i++)
+			searchJob(i);
+	}
+
+	// Ties go to the earliest root so the choice never depends on scheduling
+	for (int i = 0; i < rootCount; i++)
+	{
+		result.evaluated += m_rootEvaluated[i];
+		if (!result.found || m_scores[i] > result.score)
+		{
+			result.found = true;
+			result.hold = m_roots[i].hold;
+			result.placement = m_roots[i].placement;
+			result.score = m_scores[i];
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	m_evaluated += result.evaluated;
+	m_searchSeconds += elapsed.count();
+	m_searchCount++;
+	return result;
+}
+
+int PlacementSearch::searchRoot(const Board& board, const Root& root, uint64_t& evaluated) const
+{
+	const int branch = root.hold ? 1 : 0;
+	const PieceType* pieces = m_pieces[branch];
+
+	Board next = board;
+	int lines = 0;
+	evaluated++;
+	if (!place(next, pieces[0], root.placement, lines))
+		return kLoss;
+
+	const int depth = m_pieceCount[branch] - 1;
+	const int rest = depth > 0 ? searchFrom(next, pieces + 1, depth, evaluated) : m_evaluator.evaluate(next);
+	return rest == kLoss ? kLoss : m_evaluator.scoreLines(lines) + rest;
+}
+
+int PlacementSearch::searchFrom(const Board& board, const PieceType* pieces, int depth, uint64_t& evaluated) const
+{
+	// Topping out on spawn ends the line of play
+	if (!board.fits(pieces[0], 0, Game::kSpawnX, Game::kSpawnY))
+		return kLoss;
+
+	Placement placements[MoveGenerator::kMaxPlacements];
+	const int count = MoveGenerator::generate(board, pieces[0], 0, Game::kSpawnX, Game::kSpawnY, placements);
+
+	int best = kLoss;
+	for (int i = 0; i < count; i++)
+	{
+		Board next = board;
+		int lines = 0;
+		evaluated++;
+		if (!place(next, pieces[0], placements[i], lines))
+			continue;
+
+		const int rest = depth > 1 ? searchFrom(next, pieces + 1, depth - 1, evaluated) : m_evaluator.evaluate(next);
+		if (rest == kLoss)
+			continue;
+
+		const int score = m_evaluator.scoreLines(lines) + rest;
+		if (score > best)
+			best = score;
+	}
+	return best;
+}
+
+bool PlacementSearch::place(Board& board, PieceType type, const Placement& placement, int& lines)
+{
+	board.place(type, placement.rotation, placement.x, placement.y);
+	if (placement.y + getPieceMask(type, placement.rotation).maxY < Board::kHiddenRows)
+		return false;
+
+	lines = board.clearLines();
+	return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include "Evaluator.h"
+#include "Game/Game.h"
+#include "Game/MoveGenerator.h"
+
+class ThreadPool;
+
+struct SearchSettings
+{
+	// Pieces placed per line of play: the active piece plus depth - 1 from the preview
+	int depth = 2;
+	// Also try swapping the active piece with the held one at the root
+	bool allowHold = true;
+};
+
+struct SearchResult
+{
+	bool found;
+	bool hold;
+	Placement placement;
+	int score;
+	// Leaf and inner placements scored to reach the decision
+	uint64_t evaluated;
+};
+
+// Exhaustive lookahead over every reachable placement of the next few known pieces. Each root
+// placement is searched as its own job on the thread pool, so the result is the same however
+// many threads run it. Holding is only considered for the active piece.
+class PlacementSearch
+{
+public:
+	static constexpr int kMaxDepth = 1 + Game::kPreviewCount;
+	static constexpr int kMaxRoots = 2 * MoveGenerator::kMaxPlacements;
+
+	// Without a pool the search runs on the calling thread
+	PlacementSearch(const Evaluator& evaluator, ThreadPool* pool, const SearchSettings& settings = SearchSettings());
+
+	SearchResult findBest(const Game& game);
+
+	inline const SearchSettings& getSettings() const { return m_settings; }
+	inline uint64_t getEvaluatedCount() const { return m_evaluated; }
+	inline double getSearchSeconds() const { return m_searchSeconds; }
+	inline uint64_t getSearchCount() const { return m_searchCount; }
+
+private:
+	struct Root
+	{
+		bool hold;
+		Placement placement;
+	};
+
+	int searchRoot(const Board& board, const Root& root, uint64_t& evaluated) const;
+	int searchFrom(const Board& board, const PieceType* pieces, int depth, uint64_t& evaluated) const;
+	// Places and clears lines, returning false when the piece locked out above the field
+	static bool place(Board& board, PieceType type, const Placement& placement, int& lines);
+
+private:
+	const Evaluator& m_evaluator;
+	ThreadPool* m_pool;
+	SearchSettings m_settings;
+
+	// The pieces following the root for each branch, filled in per search
+	PieceType m_pieces[2][kMaxDepth];
+	int m_pieceCount[2];
+	Root m_roots[kMaxRoots];
+	int m_scores[kMaxRoots];
+	uint64_t m_rootEvaluated[kMaxRoots];
+
+	uint64_t m_evaluated;
+	double m_searchSeconds;
+	uint64_t m_searchCount;
+};
\ No newline at end of file
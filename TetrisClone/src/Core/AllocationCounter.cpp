@@ -0,0 +1,72 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local uint64_t t_allocations = 0;
+}
+
+uint64_t AllocationCounter::getThreadCount()
+{
+	return t_allocations;
+}
+
+#ifdef TETRIS_COUNT_ALLOCATIONS
+
+// The plain and nothrow forms are replaced. Over-aligned allocations keep the standard operators and go uncounted.
+void* operator new(size_t size)
+{
+	t_allocations++;
+	if (void* memory = malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	t_allocations++;
+	return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	free(memory);
+}
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+// Counts calls to the global operator new made by each thread. The replacement operators are only
+// compiled in when TETRIS_COUNT_ALLOCATIONS is defined, as debug builds do, so release builds keep
+// the standard ones and the count stays at zero.
+class AllocationCounter
+{
+public:
+#ifdef TETRIS_COUNT_ALLOCATIONS
+	static constexpr bool kEnabled = true;
+#else
+	static constexpr bool kEnabled = false;
+#endif
+
+	// Allocations made by the calling thread since it started
+	static uint64_t getThreadCount();
+};
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "AssetArchive.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+AssetArchive::AssetArchive(const char* filePath) : m_file(filePath), m_entries(nullptr), m_entryCount(0)
+{
+	if (m_file.getSize() < sizeof(ArchiveHeader))
+		return;
+
+	ArchiveHeader header;
+	memcpy(&header, m_file.getData(), sizeof(header));
+	if (header.magic != kMagic || header.version != kVersion)
+		return;
+
+	const uint64_t indexEnd = sizeof(ArchiveHeader) + (uint64_t)header.entryCount * sizeof(ArchiveEntry);
+	if (indexEnd > m_file.getSize())
+		return;
+
+	// Check every entry once here so lookups and reads can trust the index
+	const ArchiveEntry* entries = (const ArchiveEntry*)(m_file.getData() + sizeof(ArchiveHeader));
+	for (uint32_t i = 0; i < header.entryCount; i++)
+	{
+		const ArchiveEntry& entry = entries[i];
+		const bool compressed = (entry.flags & kCompressed) != 0;
+		if (entry.offset + entry.storedSize > m_file.getSize() || entry.nameOffset + (uint64_t)entry.nameLength > m_file.getSize()
+			|| (!compressed && entry.storedSize != entry.size) || (i > 0 && entries[i - 1].hash >= entry.hash))
+			return;
+	}
+
+	m_entries = entries;
+	m_entryCount = header.entryCount;
+}
+
+const ArchiveEntry* AssetArchive::find(const char* name) const
+{
+	if (!m_entries)
+		return nullptr;
+
+	const size_t length = strlen(name);
+	const uint64_t hash = hashName(name, length);
+	const ArchiveEntry* end = m_entries + m_entryCount;
+	const ArchiveEntry* entry = std::lower_bound(m_entries, end, hash,
+		[](const ArchiveEntry& e, uint64_t h) { return e.hash < h; });
+
+	// Names are stored as well, so a hash that happens to match another name is not taken for it
+	if (entry == end || entry->hash != hash || entry->nameLength != length
+		|| memcmp(m_file.getData() + entry->nameOffset, name, length) != 0)
+		return nullptr;
+	return entry;
+}
+
+bool AssetArchive::extract(const ArchiveEntry& entry, uint8_t* destination) const
+{
+	if (!isCompressed(entry))
+	{
+		memcpy(destination, getStoredData(entry), entry.size);
+		return true;
+	}
+	return lz4Decompress(getStoredData(entry), entry.storedSize, destination, entry.size) == entry.size;
+}
+
+uint64_t AssetArchive::hashName(const char* name, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ (uint8_t)name[i]) * 1099511628211ull;
+	return hash;
+}
+
+bool AssetArchiveWriter::add(const char* name, const void* data, size_t size, bool compress)
+{
+	const uint64_t hash = AssetArchive::hashName(name, strlen(name));
+	for (const PendingEntry& entry : m_entries)
+	{
+		if (entry.hash == hash)
+			return false;
+	}
+
+	PendingEntry entry;
+	entry.hash = hash;
+	entry.name = name;
+	entry.size = (uint32_t)size;
+	entry.compressed = false;
+
+	const uint8_t* bytes = (const uint8_t*)data;
+	if (compress && size > 0)
+	{
+		entry.data.resize(lz4CompressBound(size));
+		const size_t compressedSize = lz4Compress(bytes, size, entry.data.data(), entry.data.size());
+		if (compressedSize > 0 && compressedSize < size)
+		{
+			entry.data.resize(compressedSize);
+			entry.compressed = true;
+		}
+	}
+	if (!entry.compressed)
+		entry.data.assign(bytes, bytes + size);
+
+	m_storedBytes += entry.data.size();
+	m_sourceBytes += size;
+	m_entries.push_back(std::move(entry));
+	return true;
+}
+
+bool AssetArchiveWriter::write(const char* filePath) const
+{
+	std::vector<const PendingEntry*> sorted;
+	for (const PendingEntry& entry : m_entries)
+		sorted.push_back(&entry);
+	std::sort(sorted.begin(), sorted.end(), [](const PendingEntry* a, const PendingEntry* b) { return a->hash < b->hash; });
+
+	const ArchiveHeader header = { AssetArchive::kMagic, AssetArchive::kVersion, (uint32_t)sorted.size(), 0 };
+	std::vector<ArchiveEntry> index(sorted.size());
+	std::vector<uint8_t> names;
+
+	// Lay out the names after the index, then each entry's data aligned after those
+	uint64_t nameOffset = sizeof(ArchiveHeader) + index.size() * sizeof(ArchiveEntry);
+	for (size_t i = 0; i < sorted.size(); i++)
+	{
+		index[i].nameOffset = (uint32_t)(nameOffset + names.size());
+		index[i].nameLength = (uint16_t)sorted[i]->name.size();
+		names.insert(names.end(), sorted[i]->name.begin(), sorted[i]->name.end());
+	}
+
+	uint64_t offset = nameOffset + names.size();
+	for (size_t i = 0; i < sorted.size(); i++)
+	{
+		offset = (offset + AssetArchive::kAlignment - 1) & ~(uint64_t)(AssetArchive::kAlignment - 1);
+		index[i].hash = sorted[i]->hash;
+		index[i].offset = offset;
+		index[i].storedSize = (uint32_t)sorted[i]->data.size();
+		index[i].size = sorted[i]->size;
+		index[i].flags = sorted[i]->compressed ? AssetArchive::kCompressed : 0;
+		offset += sorted[i]->data.size();
+	}
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)index.data(), index.size() * sizeof(ArchiveEntry));
+	file.write((const char*)names.data(), names.size());
+
+	const char padding[AssetArchive::kAlignment] = {};
+	uint64_t written = nameOffset + names.size();
+	for (size_t i = 0; i < sorted.size(); i++)
+	{
+		file.write(padding, index[i].offset - written);
+		file.write((const char*)sorted[i]->data.data(), sorted[i]->data.size());
+		written = index[i].offset + sorted[i]->data.size();
+	}
+	return (bool)file;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// One file packing many assets, read through a single mapping. The header is followed by an index
+// sorted by name hash, the names, and then every entry's data on a 16 byte boundary. Entries may
+// be LZ4 compressed; uncompressed ones are used straight from the mapping without being copied.
+struct ArchiveHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t reserved;
+};
+
+struct ArchiveEntry
+{
+	uint64_t hash;
+	uint64_t offset;
+	uint32_t storedSize;
+	uint32_t size;
+	uint32_t nameOffset;
+	uint16_t nameLength;
+	uint16_t flags;
+};
+
+class AssetArchive
+{
+public:
+	static constexpr uint32_t kMagic = 0x4B415054; // "TPAK"
+	static constexpr uint32_t kVersion = 1;
+	static constexpr uint32_t kAlignment = 16;
+	static constexpr uint16_t kCompressed = 1;
+
+	explicit AssetArchive(const char* filePath);
+
+	// False if the file is missing or is not a well formed archive
+	inline bool isValid() const { return m_entries != nullptr; }
+	inline uint32_t getEntryCount() const { return m_entryCount; }
+
+	// Binary search of the index. Returns nullptr if no entry has this name.
+	const ArchiveEntry* find(const char* name) const;
+
+	inline bool isCompressed(const ArchiveEntry& entry) const { return (entry.flags & kCompressed) != 0; }
+	// The entry's bytes as stored in the mapping, which are the contents themselves unless compressed
+	inline const uint8_t* getStoredData(const ArchiveEntry& entry) const { return m_file.getData() + entry.offset; }
+	// Writes the entry's entry.size bytes of contents to destination, decompressing if needed
+	bool extract(const ArchiveEntry& entry, uint8_t* destination) const;
+
+	static uint64_t hashName(const char* name, size_t length);
+
+private:
+	MappedFile m_file;
+	const ArchiveEntry* m_entries;
+	uint32_t m_entryCount;
+};
+
+// Builds an archive in memory and writes it out in one go. Used by the packer.
+class AssetArchiveWriter
+{
+public:
+	AssetArchiveWriter() : m_storedBytes(0), m_sourceBytes(0) {}
+
+	// Compressed entries keep the compressed form only if it is smaller. Returns false if the name
+	// is already in the archive or hashes the same as one that is.
+	bool add(const char* name, const void* data, size_t size, bool compress);
+	bool write(const char* filePath) const;
+
+	inline size_t getEntryCount() const { return m_entries.size(); }
+	inline uint64_t getStoredBytes() const { return m_storedBytes; }
+	inline uint64_t getSourceBytes() const { return m_sourceBytes; }
+
+private:
+	struct PendingEntry
+	{
+		uint64_t hash;
+		std::string name;
+		std::vector<uint8_t> data;
+		uint32_t size;
+		bool compressed;
+	};
+
+	std::vector<PendingEntry> m_entries;
+	uint64_t m_storedBytes;
+	uint64_t m_sourceBytes;
+};
\ No newline at end of file
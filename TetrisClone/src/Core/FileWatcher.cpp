@@ -0,0 +1,99 @@
+#include "FileWatcher.h"
+#include <thread>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+FileWatcher::FileWatcher() : m_inotify(-1)
+{
+#ifdef __linux__
+	m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (m_inotify >= 0)
+		close(m_inotify);
+#endif
+}
+
+void FileWatcher::watch(const std::string& path)
+{
+	std::error_code error;
+	WatchedFile file;
+	file.path = path;
+	file.canonical = fs::weakly_canonical(path, error);
+	file.lastWrite = fs::last_write_time(path, error);
+	file.directoryWatch = -1;
+
+#ifdef __linux__
+	// Editors often save by writing a new file and renaming it over the old one, which a watch
+	// on the file itself would miss, so the containing directory is watched instead
+	if (m_inotify >= 0)
+	{
+		const std::string directory = file.canonical.parent_path().string();
+		file.directoryWatch = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	}
+#endif
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_files.push_back(file);
+}
+
+std::vector<std::string> FileWatcher::waitForChanges(int timeoutMs)
+{
+	std::vector<std::string> changed;
+
+#ifdef __linux__
+	if (m_inotify >= 0)
+	{
+		pollfd descriptor = { m_inotify, POLLIN, 0 };
+		if (poll(&descriptor, 1, timeoutMs) <= 0)
+			return changed;
+
+		alignas(inotify_event) char buffer[4096];
+		ssize_t length;
+		while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0)
+		{
+			for (char* cursor = buffer; cursor < buffer + length; )
+			{
+				const inotify_event* event = (const inotify_event*)cursor;
+				cursor += sizeof(inotify_event) + event->len;
+				if (event->len == 0)
+					continue;
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (const WatchedFile& file : m_files)
+				{
+					if (file.directoryWatch == event->wd && file.canonical.filename() == event->name)
+						changed.push_back(file.path);
+				}
+			}
+		}
+		return changed;
+	}
+#endif
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (WatchedFile& file : m_files)
+	{
+		std::error_code error;
+		const fs::file_time_type lastWrite = fs::last_write_time(file.path, error);
+		if (!error && lastWrite != file.lastWrite)
+		{
+			file.lastWrite = lastWrite;
+			changed.push_back(file.path);
+		}
+	}
+	return changed;
+}
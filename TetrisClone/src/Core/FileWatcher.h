@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <filesystem>
+
+// Reports files that were modified on disk. Uses inotify on Linux and compares modification
+// times elsewhere. waitForChanges blocks, so it is meant to be called from a worker thread.
+class FileWatcher
+{
+public:
+	FileWatcher();
+	~FileWatcher();
+
+	void watch(const std::string& path);
+
+	// Waits up to timeoutMs for changes and returns the watched paths that changed, if any
+	std::vector<std::string> waitForChanges(int timeoutMs);
+
+private:
+	struct WatchedFile
+	{
+		std::string path;
+		std::filesystem::path canonical;
+		std::filesystem::file_time_type lastWrite;
+		int directoryWatch;
+	};
+
+	std::vector<WatchedFile> m_files;
+	std::mutex m_mutex;
+	int m_inotify;
+};
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "FrameArena.h"
+
+FrameArena::FrameArena(size_t capacity)
+	: m_memory(new uint8_t[capacity]), m_capacity(capacity), m_used(0), m_peak(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	delete[] m_memory;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+	// Align the address rather than the offset, since the block itself is only aligned for max_align_t
+	const uintptr_t base = (uintptr_t)m_memory;
+	const uintptr_t start = (base + m_used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	const size_t end = (size_t)(start - base) + size;
+	if (end > m_capacity)
+	{
+		if (end > m_peak)
+			m_peak = end;
+		return nullptr;
+	}
+
+	m_used = end;
+	if (m_used > m_peak)
+		m_peak = m_used;
+	return (void*)start;
+}
+
+void FrameArena::reset()
+{
+	m_used = 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Linear allocator for data that only lives until the end of the frame. Allocating bumps an
+// offset into one block reserved up front and reset throws everything away at once, so
+// transient buffers cost no heap traffic. Destructors are never run, so only trivially
+// destructible types belong here.
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Returns nullptr when the arena is out of room; the peak size shows how much it needed
+	void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	template<typename T>
+	T* allocateArray(size_t count)
+	{
+		return (T*)allocate(count * sizeof(T), alignof(T));
+	}
+
+	// Call once per frame, after nothing refers to the last frame's allocations any more
+	void reset();
+
+	inline size_t getUsed() const { return m_used; }
+	inline size_t getPeak() const { return m_peak; }
+	inline size_t getCapacity() const { return m_capacity; }
+
+private:
+	uint8_t* m_memory;
+	size_t m_capacity;
+	size_t m_used;
+	size_t m_peak;
+};
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "GameLoop.h"
+#include "Rendering/Window.h"
+#include "Game/Game.h"
+#include "Game/Input.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include <thread>
+#include <cassert>
+#include <cstdio>
+
+GameLoop::GameLoop(Window& window, Game& game, const GameLoopSettings& settings)
+	: m_window(window), m_game(game), m_input(nullptr), m_settings(settings), m_frameCount(0), m_droppedTicks(0)
+{
+	m_tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / settings.tickRate;
+	m_frameDuration = settings.maxFrameRate > 0
+		? std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / settings.maxFrameRate
+		: Clock::duration::zero();
+}
+
+void GameLoop::run()
+{
+	m_window.setVSync(m_settings.vsync);
+
+	Clock::time_point previous = Clock::now();
+	Clock::duration accumulator = Clock::duration::zero();
+
+	while (!m_window.windowShouldClose())
+	{
+		if (m_settings.maxFrames > 0 && m_frameCount >= m_settings.maxFrames)
+			break;
+		if (m_input && m_input->isFinished(m_game))
+			break;
+
+		// Nothing ticks while the window is still loading, so play starts once there is something to see.
+		// These frames are not counted, leaving captures and frame limits as they were.
+		if (m_window.isLoading())
+		{
+			m_window.pollEvents();
+			m_window.render(m_game, 0.0f);
+			m_window.swapBuffers();
+			previous = Clock::now();
+			continue;
+		}
+
+		const Clock::time_point frameStart = Clock::now();
+		if (m_frameCount > 0)
+			Profiler::endFrame(std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart - previous).count());
+		accumulator += frameStart - previous;
+		previous = frameStart;
+
+		PROFILE_SCOPE("Frame");
+
+		if (m_settings.lockstep)
+		{
+			m_window.pollEvents();
+			tick(frameStart);
+			renderFrame(0.0f);
+			m_frameCount++;
+			continue;
+		}
+
+		{
+			PROFILE_SCOPE("Poll Events");
+			m_window.pollEvents();
+		}
+
+		// Run as many fixed ticks as the elapsed time covers, up to the catch up limit. The simulation
+		// trails the clock by what is left in the accumulator, which places each tick's end in time.
+		int ticks = 0;
+		while (accumulator >= m_tickDuration && ticks < m_settings.maxTicksPerFrame)
+		{
+			PROFILE_SCOPE("Tick");
+			tick(frameStart - accumulator + m_tickDuration);
+			accumulator -= m_tickDuration;
+			ticks++;
+		}
+
+		// Still behind after the limit: drop the backlog rather than falling further behind every frame
+		if (accumulator >= m_tickDuration)
+		{
+			m_droppedTicks += accumulator / m_tickDuration;
+			accumulator %= m_tickDuration;
+		}
+
+		// Nothing to show while minimized, so block on events until the next tick is due
+		if (m_window.isMinimized())
+		{
+			const Clock::duration untilTick = m_tickDuration - accumulator;
+			m_window.waitEvents(std::chrono::duration<double>(untilTick).count());
+			continue;
+		}
+
+		if (m_settings.lateLatch)
+			latchInput();
+
+		const float alpha = (float)accumulator.count() / (float)m_tickDuration.count();
+		renderFrame(alpha);
+		m_frameCount++;
+
+		if (m_frameDuration > Clock::duration::zero())
+		{
+			PROFILE_SCOPE("Sleep");
+			sleepUntil(frameStart + m_frameDuration);
+		}
+	}
+}
+
+void GameLoop::tick(Clock::time_point end)
+{
+	if (m_input)
+	{
+		m_input->setTickTime((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count());
+		m_input->update(m_game);
+	}
+	m_game.tick();
+}
+
+void GameLoop::latchInput()
+{
+	if (!m_input)
+		return;
+
+	PROFILE_SCOPE("Late Latch");
+	m_window.pollEvents();
+	m_input->latch(m_game);
+}
+
+void GameLoop::renderFrame(float alpha)
+{
+	// Ticks are left out: input recording and the AI allocate as they go, while drawing must not
+	const uint64_t allocations = AllocationCounter::getThreadCount();
+
+	m_window.render(m_game, alpha);
+	{
+		PROFILE_SCOPE("Swap Buffers");
+		m_window.swapBuffers();
+	}
+
+	if (AllocationCounter::kEnabled && m_frameCount >= kAllocationWarmupFrames && !m_window.isAllocationExpected())
+	{
+		const uint64_t frameAllocations = AllocationCounter::getThreadCount() - allocations;
+		if (frameAllocations != 0)
+			fprintf(stderr, "Frame %llu made %llu heap allocations\n", m_frameCount, (unsigned long long)frameAllocations);
+		assert(frameAllocations == 0 && "steady-state frames must not allocate");
+	}
+}
+
+void GameLoop::sleepUntil(Clock::time_point deadline)
+{
+	// Sleep through most of the wait and yield through the last stretch, since sleeps can overshoot by a scheduler quantum
+	const Clock::duration margin = std::chrono::milliseconds(2);
+	Clock::time_point now = Clock::now();
+	if (deadline - now > margin)
+		std::this_thread::sleep_for(deadline - now - margin);
+
+	while (Clock::now() < deadline)
+		std::this_thread::yield();
+}
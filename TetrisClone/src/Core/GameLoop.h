@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+
+class Window;
+class Game;
+class InputSource;
+
+struct GameLoopSettings
+{
+	// Simulation ticks per second, independent of how often frames are drawn
+	int tickRate = 60;
+	// Frames per second to cap rendering at, 0 leaves pacing to vsync
+	int maxFrameRate = 0;
+	// Most ticks run to catch up in one frame before dropping the backlog
+	int maxTicksPerFrame = 8;
+	bool vsync = true;
+	// Run exactly one tick per frame regardless of elapsed time, so captured frames are reproducible
+	bool lockstep = false;
+	// Poll once more right before drawing and apply what arrived, so the frame shows input from
+	// while the ticks ran instead of leaving it for the next frame
+	bool lateLatch = false;
+	// Frames to render before returning, 0 running until the window is closed
+	unsigned long long maxFrames = 0;
+};
+
+// Fixed timestep scheduler. Ticks the game at a constant rate from an accumulator, renders with
+// the leftover fraction of a tick for interpolation, and sleeps instead of spinning when ahead.
+class GameLoop
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Frames rendered before the allocation check starts, so caches, pools and driver state can settle
+	static constexpr unsigned long long kAllocationWarmupFrames = 120;
+
+	GameLoop(Window& window, Game& game, const GameLoopSettings& settings);
+
+	void run();
+
+	// Applied before every tick. The loop also stops once the source reports it is finished.
+	inline void setInputSource(InputSource* input) { m_input = input; }
+
+	inline const GameLoopSettings& getSettings() const { return m_settings; }
+	inline unsigned long long getFrameCount() const { return m_frameCount; }
+	inline unsigned long long getDroppedTicks() const { return m_droppedTicks; }
+
+private:
+	void sleepUntil(Clock::time_point deadline);
+	// Ticks the game, telling the input which moment the tick ends at
+	void tick(Clock::time_point end);
+	void latchInput();
+	// Renders and presents a frame, checking in debug builds that steady-state frames never touch the heap
+	void renderFrame(float alpha);
+
+private:
+	Window& m_window;
+	Game& m_game;
+	InputSource* m_input;
+	GameLoopSettings m_settings;
+	Clock::duration m_tickDuration;
+	Clock::duration m_frameDuration;
+	unsigned long long m_frameCount;
+	unsigned long long m_droppedTicks;
+};
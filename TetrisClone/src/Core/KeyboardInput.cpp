@@ -0,0 +1,218 @@
+#include "KeyboardInput.h"
+#include "Profiler.h"
+#include "Game/Game.h"
+#include "Game/Replay.h"
+#include "GLFW/glfw3.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+KeyboardInput::KeyboardInput()
+	: m_droppedEvents(0), m_recorder(nullptr), m_tickTime(0), m_held(), m_direction(Control::None), m_nextRepeat(0),
+	m_measureLatency(false), m_unpresentedCount(0)
+{
+	m_toTick.name = "Input To Tick";
+	m_toTick.count = 0;
+	m_toPresent.name = "Input To Present";
+	m_toPresent.count = 0;
+}
+
+uint64_t KeyboardInput::now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void KeyboardInput::onKey(int key, int action)
+{
+	// GLFW gives no event times of its own, so dispatch time is the closest there is. Key repeats
+	// are ignored; held directions repeat on their own schedule in autoRepeat.
+	if (action == GLFW_REPEAT)
+		return;
+
+	Control control = Control::None;
+	switch (key)
+	{
+	case GLFW_KEY_LEFT: control = Control::Left; break;
+	case GLFW_KEY_RIGHT: control = Control::Right; break;
+	case GLFW_KEY_UP:
+	case GLFW_KEY_X: control = Control::RotateClockwise; break;
+	case GLFW_KEY_Z: control = Control::RotateCounterClockwise; break;
+	case GLFW_KEY_DOWN: control = Control::SoftDrop; break;
+	case GLFW_KEY_SPACE: control = Control::HardDrop; break;
+	case GLFW_KEY_C:
+	case GLFW_KEY_LEFT_SHIFT: control = Control::Hold; break;
+	}
+	if (control == Control::None)
+		return;
+
+	// A full queue means ticks have stalled; dropping keeps the recording consistent with the game
+	if (!m_events.tryPush({ now(), control, action == GLFW_PRESS }))
+		m_droppedEvents++;
+}
+
+void KeyboardInput::setTickTime(uint64_t nanos)
+{
+	m_tickTime = nanos;
+}
+
+void KeyboardInput::update(Game& game)
+{
+	drainEvents(game);
+	autoRepeat(game, m_tickTime);
+}
+
+void KeyboardInput::latch(Game& game)
+{
+	// Repeats stay on the tick timeline; only what was actually pressed or released is pulled forward
+	drainEvents(game);
+}
+
+void KeyboardInput::drainEvents(Game& game)
+{
+	KeyEvent event;
+	while (m_events.tryPop(event))
+	{
+		handle(game, event);
+		if (!m_measureLatency)
+			continue;
+
+		m_toTick.add(now() - event.time);
+		if (m_unpresentedCount < (int)kQueueCapacity)
+			m_unpresented[m_unpresentedCount++] = event.time;
+	}
+}
+
+void KeyboardInput::handle(Game& game, const KeyEvent& event)
+{
+	switch (event.control)
+	{
+	case Control::Left:
+	case Control::Right:
+	{
+		const int side = event.control == Control::Left ? 0 : 1;
+		const Control other = event.control == Control::Left ? Control::Right : Control::Left;
+		m_held[side] = event.pressed;
+		if (event.pressed)
+		{
+			// The press moves at once and the delay counts from when the key went down, not when it was seen
+			m_direction = event.control;
+			m_nextRepeat = event.time + m_autoRepeat.delayNanos;
+			shift(game);
+		}
+		else if (m_direction == event.control)
+		{
+			// Letting go of the newer direction hands over to the older one if it is still held, charging afresh
+			m_direction = m_held[1 - side] ? other : Control::None;
+			m_nextRepeat = event.time + m_autoRepeat.delayNanos;
+		}
+		break;
+	}
+	case Control::RotateClockwise:
+		if (event.pressed)
+			apply(game, InputAction::RotateClockwise);
+		break;
+	case Control::RotateCounterClockwise:
+		if (event.pressed)
+			apply(game, InputAction::RotateCounterClockwise);
+		break;
+	case Control::SoftDrop:
+		apply(game, event.pressed ? InputAction::SoftDropOn : InputAction::SoftDropOff);
+		break;
+	case Control::HardDrop:
+		if (event.pressed)
+			apply(game, InputAction::HardDrop);
+		break;
+	case Control::Hold:
+		if (event.pressed)
+			apply(game, InputAction::Hold);
+		break;
+	default:
+		break;
+	}
+}
+
+void KeyboardInput::autoRepeat(Game& game, uint64_t until)
+{
+	if (m_direction == Control::None || m_nextRepeat > until)
+		return;
+
+	if (m_autoRepeat.rateNanos == 0)
+	{
+		while (shift(game))
+		{
+		}
+		m_nextRepeat = until + 1;
+		return;
+	}
+
+	// Every repeat due by the end of this tick, several when the rate is faster than the tick rate
+	while (m_nextRepeat <= until)
+	{
+		if (!shift(game))
+		{
+			// Against a wall: skip the repeats already due but keep the phase for when the way clears
+			m_nextRepeat += ((until - m_nextRepeat) / m_autoRepeat.rateNanos + 1) * m_autoRepeat.rateNanos;
+			break;
+		}
+		m_nextRepeat += m_autoRepeat.rateNanos;
+	}
+}
+
+bool KeyboardInput::shift(Game& game)
+{
+	// Only moves that happened are recorded, so holding against a wall leaves nothing in the replay
+	const InputAction action = m_direction == Control::Left ? InputAction::MoveLeft : InputAction::MoveRight;
+	const bool moved = action == InputAction::MoveLeft ? game.moveLeft() : game.moveRight();
+	if (moved && m_recorder)
+		m_recorder->record(game.getTickCount(), action);
+	return moved;
+}
+
+void KeyboardInput::apply(Game& game, InputAction action)
+{
+	if (m_recorder)
+		m_recorder->record(game.getTickCount(), action);
+	game.apply(action);
+}
+
+void KeyboardInput::onPresented()
+{
+	if (m_unpresentedCount == 0)
+		return;
+
+	const uint64_t presented = now();
+	for (int i = 0; i < m_unpresentedCount; i++)
+		m_toPresent.add(presented - m_unpresented[i]);
+	m_unpresentedCount = 0;
+}
+
+void KeyboardInput::printLatencySummary() const
+{
+	const int events = m_toTick.count < kLatencySamples ? m_toTick.count : kLatencySamples;
+	printf("Input latency in microseconds over the last %d events, %u dropped by a full queue\n", events, m_droppedEvents);
+	m_toTick.print();
+	m_toPresent.print();
+}
+
+void KeyboardInput::LatencySamples::add(uint64_t nanos)
+{
+	micros[count % kLatencySamples] = (uint32_t)(nanos / 1000);
+	count++;
+	if (Profiler::isEnabled())
+		Profiler::recordCounter(name, nanos / 1000);
+}
+
+void KeyboardInput::LatencySamples::print() const
+{
+	const int samples = count < kLatencySamples ? count : kLatencySamples;
+	if (samples == 0)
+	{
+		printf("  %-17s no events\n", name);
+		return;
+	}
+
+	uint32_t sorted[kLatencySamples];
+	std::copy(micros, micros + samples, sorted);
+	std::sort(sorted, sorted + samples);
+	printf("  %-17s p50 %u  p99 %u  max %u\n", name, sorted[samples / 2], sorted[samples * 99 / 100], sorted[samples - 1]);
+}
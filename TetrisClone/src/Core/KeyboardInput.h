@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Game/Input.h"
+#include "SpscQueue.h"
+
+class InputRecorder;
+
+// Delayed auto shift and auto repeat rate for held directions, measured from key event timestamps
+struct AutoRepeatSettings
+{
+	// How long a direction is held before it starts repeating
+	uint64_t delayNanos = 167000000;
+	// Time between repeated moves after that, 0 sliding all the way to the wall at once
+	uint64_t rateNanos = 33000000;
+};
+
+// Turns key events from the window into game actions. The key callback stamps each event with the
+// time it was dispatched and pushes it onto a lock free queue that ticks drain, so the window never
+// waits on the simulation. Presses and releases are applied by the first tick after they arrive,
+// which is also the tick they are recorded against, so a recording replays exactly what the game
+// saw. Held directions are repeated here from the press timestamp rather than by the system's key
+// repeat, each repeat landing on the tick whose time covers it.
+class KeyboardInput : public InputSource
+{
+public:
+	static constexpr size_t kQueueCapacity = 256;
+	// Latency samples kept for the summary, the oldest overwritten first
+	static constexpr int kLatencySamples = 4096;
+
+	KeyboardInput();
+
+	// Takes GLFW key codes and actions
+	void onKey(int key, int action);
+	// Called once the frame has been handed over for presenting, ending any input-to-present measurements
+	void onPresented();
+
+	inline void setRecorder(InputRecorder* recorder) { m_recorder = recorder; }
+	inline void setAutoRepeat(const AutoRepeatSettings& settings) { m_autoRepeat = settings; }
+	// Measures how long events take to reach a tick and to reach the screen
+	inline void setMeasureLatency(bool enabled) { m_measureLatency = enabled; }
+	void printLatencySummary() const;
+
+	void setTickTime(uint64_t nanos) override;
+	void update(Game& game) override;
+	void latch(Game& game) override;
+
+	// Nanoseconds on the steady clock, which event and tick times are both given in
+	static uint64_t now();
+
+private:
+	enum class Control : uint8_t
+	{
+		Left, Right, RotateClockwise, RotateCounterClockwise, SoftDrop, HardDrop, Hold, None
+	};
+
+	struct KeyEvent
+	{
+		uint64_t time;
+		Control control;
+		bool pressed;
+	};
+
+	struct LatencySamples
+	{
+		// Also names the profiler counter the samples are mirrored to
+		const char* name;
+		uint32_t micros[kLatencySamples];
+		int count;
+
+		void add(uint64_t nanos);
+		void print() const;
+	};
+
+	void drainEvents(Game& game);
+	void handle(Game& game, const KeyEvent& event);
+	void autoRepeat(Game& game, uint64_t until);
+	bool shift(Game& game);
+	void apply(Game& game, InputAction action);
+
+private:
+	SpscQueue<KeyEvent, kQueueCapacity> m_events;
+	unsigned int m_droppedEvents;
+	InputRecorder* m_recorder;
+	AutoRepeatSettings m_autoRepeat;
+	uint64_t m_tickTime;
+
+	// Both directions can be held at once, the one pressed last winning
+	bool m_held[2];
+	Control m_direction;
+	uint64_t m_nextRepeat;
+
+	bool m_measureLatency;
+	// Timestamps of events applied since the last present
+	uint64_t m_unpresented[kQueueCapacity];
+	int m_unpresentedCount;
+	LatencySamples m_toTick;
+	LatencySamples m_toPresent;
+};
\ No newline at end of file
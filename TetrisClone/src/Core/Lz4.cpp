@@ -0,0 +1,157 @@
+#include "Lz4.h"
+#include <cstring>
+
+namespace
+{
+	const size_t kMinMatch = 4;
+	// The format requires the last five bytes to be literals and the last match to start at least twelve from the end
+	const size_t kLastLiterals = 5;
+	const size_t kMatchLimit = 12;
+	const size_t kMaxOffset = 65535;
+	const int kHashBits = 12;
+
+	inline uint32_t read32(const uint8_t* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	inline uint32_t hashSequence(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - kHashBits);
+	}
+
+	// Lengths past the token's nibble continue in bytes of 255, ended by one below 255
+	inline uint8_t* writeLength(uint8_t* out, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			*out++ = 255;
+		*out++ = (uint8_t)length;
+		return out;
+	}
+
+	inline bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length)
+	{
+		uint8_t byte;
+		do
+		{
+			if (in == end)
+				return false;
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	// Writes literals followed by a match, or just the literals when matchLength is zero
+	uint8_t* writeSequence(uint8_t* out, const uint8_t* outEnd, const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength)
+	{
+		const size_t worstCase = 1 + literalCount / 255 + 1 + literalCount + 2 + matchLength / 255 + 1;
+		if ((size_t)(outEnd - out) < worstCase)
+			return nullptr;
+
+		uint8_t* token = out++;
+		*token = (uint8_t)((literalCount < 15 ? literalCount : 15) << 4);
+		if (literalCount >= 15)
+			out = writeLength(out, literalCount - 15);
+		memcpy(out, literals, literalCount);
+		out += literalCount;
+
+		if (matchLength == 0)
+			return out;
+
+		*out++ = (uint8_t)(offset & 0xFF);
+		*out++ = (uint8_t)(offset >> 8);
+		const size_t extra = matchLength - kMinMatch;
+		*token |= (uint8_t)(extra < 15 ? extra : 15);
+		if (extra >= 15)
+			out = writeLength(out, extra - 15);
+		return out;
+	}
+}
+
+size_t lz4Compress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity)
+{
+	uint32_t table[1 << kHashBits] = {};
+	uint8_t* out = destination;
+	uint8_t* const outEnd = destination + capacity;
+	size_t anchor = 0;
+	size_t position = 0;
+
+	while (size > kMatchLimit && position < size - kMatchLimit)
+	{
+		// Positions in the table may be stale or collide, so a candidate only counts if its bytes match
+		const uint32_t sequence = read32(source + position);
+		const uint32_t hash = hashSequence(sequence);
+		const size_t candidate = table[hash];
+		table[hash] = (uint32_t)position;
+		if (candidate >= position || position - candidate > kMaxOffset || read32(source + candidate) != sequence)
+		{
+			position++;
+			continue;
+		}
+
+		size_t length = kMinMatch;
+		while (position + length < size - kLastLiterals && source[candidate + length] == source[position + length])
+			length++;
+
+		out = writeSequence(out, outEnd, source + anchor, position - anchor, position - candidate, length);
+		if (!out)
+			return 0;
+
+		position += length;
+		anchor = position;
+	}
+
+	out = writeSequence(out, outEnd, source + anchor, size - anchor, 0, 0);
+	return out ? (size_t)(out - destination) : 0;
+}
+
+size_t lz4Decompress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity)
+{
+	const uint8_t* in = source;
+	const uint8_t* const inEnd = source + size;
+	uint8_t* out = destination;
+	uint8_t* const outEnd = destination + capacity;
+
+	while (in < inEnd)
+	{
+		const uint8_t token = *in++;
+
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !readLength(in, inEnd, literalCount))
+			return 0;
+		if ((size_t)(inEnd - in) < literalCount || (size_t)(outEnd - out) < literalCount)
+			return 0;
+		memcpy(out, in, literalCount);
+		in += literalCount;
+		out += literalCount;
+
+		// The last sequence has literals only
+		if (in == inEnd)
+			break;
+
+		if (inEnd - in < 2)
+			return 0;
+		const size_t offset = (size_t)in[0] | (size_t)in[1] << 8;
+		in += 2;
+		if (offset == 0 || offset > (size_t)(out - destination))
+			return 0;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(in, inEnd, matchLength))
+			return 0;
+		matchLength += kMinMatch;
+		if ((size_t)(outEnd - out) < matchLength)
+			return 0;
+
+		// Matches may overlap what they are writing, which repeats the bytes, so copy forwards one at a time
+		const uint8_t* match = out - offset;
+		for (size_t i = 0; i < matchLength; i++)
+			out[i] = match[i];
+		out += matchLength;
+	}
+
+	return (size_t)(out - destination);
+}
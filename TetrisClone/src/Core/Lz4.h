@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Compression in the LZ4 block format, so archives stay readable by the reference tools. The
+// compressor is a simple greedy one meant for offline packing; the decompressor is the part that
+// runs at load time and checks every length against both buffers.
+
+// Largest output lz4Compress can produce for size bytes of input
+inline size_t lz4CompressBound(size_t size) { return size + size / 255 + 16; }
+
+// Returns the compressed size, or 0 if the result would not fit in capacity
+size_t lz4Compress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity);
+
+// Returns the number of bytes written, or 0 if the input is malformed or would overrun capacity
+size_t lz4Decompress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity);
\ No newline at end of file
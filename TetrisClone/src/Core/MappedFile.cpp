@@ -0,0 +1,114 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* filePath) : m_data(nullptr), m_size(0), m_valid(false)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	m_size = (size_t)size.QuadPart;
+	m_valid = true;
+	if (m_size > 0)
+	{
+		// The view keeps the mapping alive, so both handles can be closed straight away
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			m_data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+		m_valid = m_data != nullptr;
+	}
+	CloseHandle(file);
+#else
+	const int file = open(filePath, O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat info;
+	if (fstat(file, &info) != 0)
+	{
+		::close(file);
+		return;
+	}
+
+	m_size = (size_t)info.st_size;
+	m_valid = true;
+	if (m_size > 0)
+	{
+		// The mapping holds its own reference to the file, so the descriptor can be closed straight away
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+		{
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			m_data = (const uint8_t*)data;
+		}
+		m_valid = m_data != nullptr;
+	}
+	::close(file);
+#endif
+
+	if (!m_valid)
+		m_size = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : m_data(other.m_data), m_size(other.m_size), m_valid(other.m_valid)
+{
+	other.m_data = nullptr;
+	other.m_size = 0;
+	other.m_valid = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		m_data = other.m_data;
+		m_size = other.m_size;
+		m_valid = other.m_valid;
+		other.m_data = nullptr;
+		other.m_size = 0;
+		other.m_valid = false;
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+void MappedFile::close()
+{
+	if (m_data)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+#else
+		munmap((void*)m_data, m_size);
+#endif
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_valid = false;
+}
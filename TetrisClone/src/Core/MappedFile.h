@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Read-only view of a whole file mapped into memory, so it can be parsed in place without copying
+// it through a stream. Uses mmap on POSIX systems and a file mapping on Windows.
+class MappedFile
+{
+public:
+	MappedFile() : m_data(nullptr), m_size(0), m_valid(false) {}
+	explicit MappedFile(const char* filePath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	// False if the file could not be opened. An empty file is valid but has no data.
+	inline bool isValid() const { return m_valid; }
+	inline const uint8_t* getData() const { return m_data; }
+	inline size_t getSize() const { return m_size; }
+
+private:
+	void close();
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	bool m_valid;
+};
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "Profiler.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+
+std::atomic<bool> Profiler::s_enabled(false);
+
+namespace
+{
+	struct ScopeEvent
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t end;
+		bool counter;
+	};
+
+	// Written only by its owning thread. head counts every event ever pushed, so readers
+	// know both where the newest event is and whether the ring has wrapped.
+	struct ThreadEvents
+	{
+		uint32_t threadID;
+		std::atomic<uint64_t> head;
+		ScopeEvent events[Profiler::kEventCapacity];
+
+		void push(const char* name, uint64_t start, uint64_t end, bool counter = false)
+		{
+			const uint64_t index = head.load(std::memory_order_relaxed);
+			events[index % Profiler::kEventCapacity] = { name, start, end, counter };
+			head.store(index + 1, std::memory_order_release);
+		}
+	};
+
+	const uint32_t kGpuThreadID = 0;
+
+	const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+	// Buffers are only ever added, so a thread's pointer stays valid for the life of the process
+	std::mutex s_threadsMutex;
+	std::vector<std::unique_ptr<ThreadEvents>> s_threads;
+
+	// Frame data is only touched from the main loop's thread
+	uint64_t s_histogram[Profiler::kHistogramBuckets];
+	uint64_t s_frameCount = 0;
+	uint64_t s_maxFrameNanos = 0;
+	float s_recentFrames[Profiler::kRecentFrameCount];
+	uint64_t s_recentHead = 0;
+
+	ThreadEvents* registerThread(uint32_t threadID)
+	{
+		std::unique_ptr<ThreadEvents> events(new ThreadEvents());
+		events->threadID = threadID;
+		events->head.store(0, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(s_threadsMutex);
+		s_threads.push_back(std::move(events));
+		return s_threads.back().get();
+	}
+
+	ThreadEvents& getThreadEvents()
+	{
+		static std::atomic<uint32_t> nextThreadID(kGpuThreadID + 1);
+		thread_local ThreadEvents* events = registerThread(nextThreadID++);
+		return *events;
+	}
+
+	ThreadEvents& getGpuEvents()
+	{
+		static ThreadEvents* events = registerThread(kGpuThreadID);
+		return *events;
+	}
+
+	double percentileMs(double fraction)
+	{
+		const uint64_t target = (uint64_t)(fraction * (double)s_frameCount);
+		uint64_t seen = 0;
+		for (int i = 0; i < Profiler::kHistogramBuckets; i++)
+		{
+			seen += s_histogram[i];
+			if (seen > target)
+			{
+				// Report the middle of the bucket, but never more than the slowest frame actually seen
+				const double bucketMs = (i + 0.5) * Profiler::kHistogramBucketMicros / 1000.0;
+				const double maxMs = s_maxFrameNanos / 1000000.0;
+				return bucketMs < maxMs ? bucketMs : maxMs;
+			}
+		}
+		return s_maxFrameNanos / 1000000.0;
+	}
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+	s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+	// Offset by one so that a real timestamp is never zero, which ProfileScope uses to mean disabled
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count() + 1;
+}
+
+void Profiler::recordScope(const char* name, uint64_t start, uint64_t end)
+{
+	getThreadEvents().push(name, start, end);
+}
+
+void Profiler::recordGpuScope(const char* name, uint64_t start, uint64_t end)
+{
+	getGpuEvents().push(name, start, end);
+}
+
+void Profiler::recordCounter(const char* name, uint64_t value)
+{
+	// Counters reuse the event slot, with the value stored where a scope keeps its end time
+	getThreadEvents().push(name, now(), value, true);
+}
+
+void Profiler::endFrame(uint64_t frameNanos)
+{
+	if (!isEnabled())
+		return;
+
+	const uint64_t bucket = frameNanos / 1000 / kHistogramBucketMicros;
+	s_histogram[bucket < kHistogramBuckets ? bucket : kHistogramBuckets - 1]++;
+	s_frameCount++;
+	if (frameNanos > s_maxFrameNanos)
+		s_maxFrameNanos = frameNanos;
+
+	s_recentFrames[s_recentHead % kRecentFrameCount] = frameNanos / 1000000.0f;
+	s_recentHead++;
+}
+
+Profiler::FrameStats Profiler::getFrameStats()
+{
+	FrameStats stats = { s_frameCount, 0.0, 0.0, 0.0 };
+	if (s_frameCount == 0)
+		return stats;
+
+	stats.p50Ms = percentileMs(0.50);
+	stats.p99Ms = percentileMs(0.99);
+	stats.maxMs = s_maxFrameNanos / 1000000.0;
+	return stats;
+}
+
+int Profiler::getRecentFrames(float* millis, int capacity)
+{
+	const uint64_t available = s_recentHead < kRecentFrameCount ? s_recentHead : kRecentFrameCount;
+	const int count = (int)(available < (uint64_t)capacity ? available : (uint64_t)capacity);
+	for (int i = 0; i < count; i++)
+		millis[i] = s_recentFrames[(s_recentHead - count + i) % kRecentFrameCount];
+	return count;
+}
+
+bool Profiler::writeChromeTrace(const char* filePath)
+{
+	std::ofstream file(filePath);
+	if (!file)
+		return false;
+
+	// Trace event format, with timestamps and durations in microseconds
+	file << "{\"traceEvents\":[\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << kGpuThreadID << ",\"args\":{\"name\":\"GPU\"}}";
+
+	std::lock_guard<std::mutex> lock(s_threadsMutex);
+	char line[256];
+	for (const std::unique_ptr<ThreadEvents>& thread : s_threads)
+	{
+		const uint64_t head = thread->head.load(std::memory_order_acquire);
+		const uint64_t first = head > kEventCapacity ? head - kEventCapacity : 0;
+		for (uint64_t i = first; i < head; i++)
+		{
+			const ScopeEvent& event = thread->events[i % kEventCapacity];
+			if (event.counter)
+				snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%llu}}",
+					event.name, event.start / 1000.0, (unsigned long long)event.end);
+			else
+				snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					event.name, thread->threadID, event.start / 1000.0, (event.end - event.start) / 1000.0);
+			file << line;
+		}
+	}
+
+	file << "\n]}\n";
+	return true;
+}
+
+void Profiler::printSummary()
+{
+	const FrameStats stats = getFrameStats();
+	printf("Frames: %llu  p50: %.2f ms  p99: %.2f ms  max: %.2f ms\n",
+		(unsigned long long)stats.frames, stats.p50Ms, stats.p99Ms, stats.maxMs);
+}
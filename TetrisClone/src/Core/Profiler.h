@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+
+// Records named CPU scopes into per-thread ring buffers and frame times into a histogram.
+// Each thread only ever writes its own buffer, so recording takes no locks, and while the
+// profiler is disabled a scope costs a single relaxed load.
+class Profiler
+{
+public:
+	static constexpr uint32_t kEventCapacity = 1 << 16;
+	static constexpr int kRecentFrameCount = 240;
+	// Frame time histogram in 0.1 ms buckets up to 100 ms, longer frames landing in the last one
+	static constexpr int kHistogramBuckets = 1000;
+	static constexpr int kHistogramBucketMicros = 100;
+
+	struct FrameStats
+	{
+		uint64_t frames;
+		double p50Ms;
+		double p99Ms;
+		double maxMs;
+	};
+
+	static inline bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+	static void setEnabled(bool enabled);
+
+	// Nanoseconds on the clock every event is stamped with
+	static uint64_t now();
+
+	static void recordScope(const char* name, uint64_t start, uint64_t end);
+	// GPU work lands on its own track, with times already converted to the CPU clock
+	static void recordGpuScope(const char* name, uint64_t start, uint64_t end);
+	// Records a sampled value, shown as a counter track in the trace
+	static void recordCounter(const char* name, uint64_t value);
+	static void endFrame(uint64_t frameNanos);
+
+	static FrameStats getFrameStats();
+	// Copies the most recent frame times in milliseconds, oldest first, and returns how many were written
+	static int getRecentFrames(float* millis, int capacity);
+
+	static bool writeChromeTrace(const char* filePath);
+	static void printSummary();
+
+private:
+	static std::atomic<bool> s_enabled;
+};
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name) : m_name(name), m_start(Profiler::isEnabled() ? Profiler::now() : 0) {}
+	~ProfileScope()
+	{
+		if (m_start != 0)
+			Profiler::recordScope(m_name, m_start, Profiler::now());
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* m_name;
+	uint64_t m_start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. Each index is
+// only written by one side, so pushing and popping are a load and a store each and never block.
+// Capacity must be a power of two; one slot is always left empty to tell full from empty.
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	SpscQueue() : m_head(0), m_tail(0) {}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer only. Returns false, leaving the queue untouched, when it is full.
+	bool tryPush(const T& value)
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		const size_t next = (tail + 1) & (Capacity - 1);
+		if (next == m_head.load(std::memory_order_acquire))
+			return false;
+
+		m_items[tail] = value;
+		m_tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only. Returns false when there is nothing to take.
+	bool tryPop(T& value)
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		value = m_items[head];
+		m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+	// Either side may call this, though the answer can be stale by the time it returns
+	inline bool isEmpty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+private:
+	T m_items[Capacity];
+	// Kept on separate cache lines so the two threads do not invalidate each other's index
+	alignas(64) std::atomic<size_t> m_head;
+	alignas(64) std::atomic<size_t> m_tail;
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+	: m_queued(0), m_remaining(0), m_steals(0), m_stopping(false)
+{
+	if (threadCount <= 0)
+		threadCount = (int)std::thread::hardware_concurrency();
+	if (threadCount <= 0)
+		threadCount = 1;
+
+	m_queueCount = threadCount;
+	m_queues = new Queue[m_queueCount];
+	for (int i = 0; i < m_queueCount - 1; i++)
+		m_workers.emplace_back(&ThreadPool::workerMain, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+
+	for (std::thread& worker : m_workers)
+		worker.join();
+	delete[] m_queues;
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& task)
+{
+	if (count <= 0)
+		return;
+
+	// Deal the jobs out round robin so every queue starts with its share and stealing only evens out the rest
+	m_remaining.store(count, std::memory_order_relaxed);
+	for (int i = 0; i < count; i++)
+	{
+		Queue& queue = m_queues[i % m_queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back({ &task, i });
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_queued.fetch_add(count, std::memory_order_relaxed);
+	}
+	m_wake.notify_all();
+
+	const int self = m_queueCount - 1;
+	while (m_remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (!runOne(self))
+			std::this_thread::yield();
+	}
+}
+
+void ThreadPool::workerMain(int queueIndex)
+{
+	for (;;)
+	{
+		if (runOne(queueIndex))
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_relaxed) > 0; });
+		if (m_stopping)
+			return;
+	}
+}
+
+bool ThreadPool::runOne(int queueIndex)
+{
+	Job job = {};
+	bool found = false;
+
+	{
+		Queue& own = m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty())
+		{
+			job = own.jobs.back();
+			own.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	for (int i = 1; i < m_queueCount && !found; i++)
+	{
+		Queue& victim = m_queues[(queueIndex + i) % m_queueCount];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty())
+		{
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			found = true;
+			m_steals.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (!found)
+		return false;
+
+	m_queued.fetch_sub(1, std::memory_order_relaxed);
+	(*job.task)(job.index);
+	m_remaining.fetch_sub(1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own deque of jobs. A worker runs its newest job first
+// and steals the oldest job of another queue once its own runs dry, so jobs of very different cost
+// still keep every core busy.
+class ThreadPool
+{
+public:
+	// 0 uses every hardware thread, the thread calling parallelFor counting as one of them
+	explicit ThreadPool(int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Runs task(i) for every i in [0, count) and returns once all of them have finished. The calling
+	// thread works through jobs as well. Tasks must not call parallelFor on the same pool.
+	void parallelFor(int count, const std::function<void(int)>& task);
+
+	inline int getThreadCount() const { return m_queueCount; }
+	inline uint64_t getStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+	struct Job
+	{
+		const std::function<void(int)>* task;
+		int index;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void workerMain(int queueIndex);
+	bool runOne(int queueIndex);
+
+private:
+	std::vector<std::thread> m_workers;
+	// One queue per worker, the last belonging to the caller
+	Queue* m_queues;
+	int m_queueCount;
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	std::atomic<int> m_queued;
+	std::atomic<int> m_remaining;
+	std::atomic<uint64_t> m_steals;
+	bool m_stopping;
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Board.h"
+
+void Board::clear()
+{
+	for (int y = 0; y < kHeight; y++)
+	{
+		m_rows[y] = kEmptyRow;
+		for (int p = 0; p < kColorPlanes; p++)
+			m_colors[p][y] = 0;
+	}
+	for (int y = kHeight; y < kHeight + 4; y++)
+		m_rows[y] = kFullRow;
+}
+
+bool Board::fits(PieceType type, int rotation, int x, int y) const
+{
+	const PieceMask& mask = getPieceMask(type, rotation);
+	if (y + mask.minY < 0)
+		return false;
+
+	// Keep the shifted 4 bit box inside the 16 bit row; anything nearer the edge lands in the walls
+	if ((unsigned int)(x + kWallBits) > 12)
+		return false;
+
+	uint16_t hit = 0;
+	for (int r = mask.minY; r <= mask.maxY; r++)
+		hit |= m_rows[y + r] & shiftMask(mask.rows[r], x);
+	return hit == 0;
+}
+
+int Board::dropDistance(PieceType type, int rotation, int x, int y) const
+{
+	int distance = 0;
+	while (fits(type, rotation, x, y + distance + 1))
+		distance++;
+	return distance;
+}
+
+void Board::place(PieceType type, int rotation, int x, int y)
+{
+	const PieceMask& mask = getPieceMask(type, rotation);
+	const unsigned int color = (unsigned int)type + 1;
+	for (int r = mask.minY; r <= mask.maxY; r++)
+	{
+		const uint16_t bits = shiftMask(mask.rows[r], x);
+		m_rows[y + r] |= bits;
+		for (int p = 0; p < kColorPlanes; p++)
+		{
+			if ((color >> p) & 1)
+				m_colors[p][y + r] |= bits;
+		}
+	}
+}
+
+int Board::clearLines(uint32_t* clearedRows)
+{
+	// Compact from the bottom up, copying every row that is not full down over the cleared ones
+	uint32_t cleared = 0;
+	int write = kHeight - 1;
+	for (int read = kHeight - 1; read >= 0; read--)
+	{
+		if (m_rows[read] == kFullRow)
+		{
+			cleared |= 1u << read;
+			continue;
+		}
+
+		if (write != read)
+		{
+			m_rows[write] = m_rows[read];
+			for (int p = 0; p < kColorPlanes; p++)
+				m_colors[p][write] = m_colors[p][read];
+		}
+		write--;
+	}
+
+	for (; write >= 0; write--)
+	{
+		m_rows[write] = kEmptyRow;
+		for (int p = 0; p < kColorPlanes; p++)
+			m_colors[p][write] = 0;
+	}
+
+	if (clearedRows)
+		*clearedRows = cleared;
+
+	int count = 0;
+	for (uint32_t bits = cleared; bits; bits &= bits - 1)
+		count++;
+	return count;
+}
+
+int Board::getCellColor(int x, int y) const
+{
+	const int bit = x + kWallBits;
+	int color = 0;
+	for (int p = 0; p < kColorPlanes; p++)
+		color |= ((m_colors[p][y] >> bit) & 1) << p;
+	return color;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include "Tetromino.h"
+
+class Board
+{
+public:
+	static constexpr int kWidth = 10;
+	static constexpr int kHeight = 24;
+	static constexpr int kVisibleHeight = 20;
+	static constexpr int kHiddenRows = kHeight - kVisibleHeight;
+
+	// Each row keeps its cells in bits 3..12 with the walls set on both sides, so
+	// testing a piece against the board is a single AND per piece row.
+	static constexpr int kWallBits = 3;
+	static constexpr uint16_t kCellMask = 0x03FF << kWallBits;
+	static constexpr uint16_t kEmptyRow = (uint16_t)~kCellMask;
+	static constexpr uint16_t kFullRow = 0xFFFF;
+
+	// Cell colors are stored as bit planes alongside the rows so that line clears
+	// move them with the same word copies as the occupancy bits.
+	static constexpr int kColorPlanes = 3;
+
+	Board() { clear(); }
+
+	void clear();
+
+	bool fits(PieceType type, int rotation, int x, int y) const;
+	int dropDistance(PieceType type, int rotation, int x, int y) const;
+
+	void place(PieceType type, int rotation, int x, int y);
+	int clearLines(uint32_t* clearedRows = nullptr);
+
+	inline uint16_t getRow(int y) const { return m_rows[y]; }
+	inline uint16_t getCells(int y) const { return (uint16_t)((m_rows[y] & kCellMask) >> kWallBits); }
+	inline bool isOccupied(int x, int y) const { return (m_rows[y] >> (x + kWallBits)) & 1; }
+	int getCellColor(int x, int y) const;
+	inline uint16_t getColorPlane(int plane, int y) const { return m_colors[plane][y]; }
+
+	// Position a 4 wide piece mask row at board column x
+	static inline uint16_t shiftMask(uint16_t mask, int x) { return (uint16_t)(mask << (x + kWallBits)); }
+
+private:
+	// Rows past the bottom are solid so the floor needs no bounds check
+	uint16_t m_rows[kHeight + 4];
+	uint16_t m_colors[kColorPlanes][kHeight];
+};
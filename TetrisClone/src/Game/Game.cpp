@@ -0,0 +1,290 @@
+#include "Game.h"
+
+namespace
+{
+	// Guideline gravity curve in milliseconds per row, indexed by level - 1
+	const int kMillisPerRow[] = { 1000, 793, 618, 473, 355, 262, 190, 135, 94, 64, 43, 28, 18, 11, 7 };
+	const int kLevelCount = sizeof(kMillisPerRow) / sizeof(kMillisPerRow[0]);
+}
+
+Game::Game(uint32_t seed, int tickRate)
+	: m_tickRate(tickRate), m_microsPerTick(1000000 / tickRate)
+{
+	reset(seed);
+}
+
+void Game::reset(uint32_t seed)
+{
+	m_board.clear();
+	m_randomizer.reset(seed);
+
+	m_held = PieceType::None;
+	m_canHold = true;
+	m_previewHead = 0;
+	for (int i = 0; i < kPreviewCount; i++)
+		m_preview[i] = m_randomizer.next();
+
+	m_gravityMicros = 0;
+	m_lockMicros = 0;
+	m_lockResets = 0;
+	m_softDrop = false;
+
+	m_tickCount = 0;
+	m_score = 0;
+	m_lines = 0;
+	m_level = 1;
+	m_piecesPlaced = 0;
+	m_gameOver = false;
+
+	spawn(nextFromQueue());
+	m_previousPiece = m_piece;
+	m_lastLock = { m_piece, 0, 0 };
+}
+
+void Game::tick()
+{
+	if (m_gameOver)
+		return;
+
+	m_tickCount++;
+	m_previousPiece = m_piece;
+
+	// Accumulate gravity in microseconds so any tick rate gives the same fall speed
+	const int rowMicros = getMicrosPerRow();
+	m_gravityMicros += m_softDrop ? m_microsPerTick * kSoftDropFactor : m_microsPerTick;
+	while (m_gravityMicros >= rowMicros)
+	{
+		if (!tryMove(0, 1))
+		{
+			m_gravityMicros = 0;
+			break;
+		}
+
+		m_gravityMicros -= rowMicros;
+		if (m_softDrop)
+			m_score++;
+	}
+
+	if (isGrounded())
+	{
+		m_lockMicros += m_microsPerTick;
+		if (m_lockMicros >= kLockDelayMicros)
+			lockPiece();
+	}
+	else
+	{
+		m_lockMicros = 0;
+	}
+}
+
+bool Game::moveLeft()
+{
+	return tryMove(-1, 0);
+}
+
+bool Game::moveRight()
+{
+	return tryMove(1, 0);
+}
+
+bool Game::rotateClockwise()
+{
+	return tryRotate(true);
+}
+
+bool Game::rotateCounterClockwise()
+{
+	return tryRotate(false);
+}
+
+void Game::setSoftDrop(bool enabled)
+{
+	m_softDrop = enabled;
+}
+
+void Game::hardDrop()
+{
+	if (m_gameOver)
+		return;
+
+	const int distance = m_board.dropDistance(m_piece.type, m_piece.rotation, m_piece.x, m_piece.y);
+	m_piece.y += distance;
+	m_score += 2 * (uint64_t)distance;
+	lockPiece(distance);
+}
+
+bool Game::hold()
+{
+	if (m_gameOver || !m_canHold)
+		return false;
+
+	const PieceType current = m_piece.type;
+	if (m_held == PieceType::None)
+		spawn(nextFromQueue());
+	else
+		spawn(m_held);
+
+	m_held = current;
+	m_canHold = false;
+	return true;
+}
+
+void Game::apply(InputAction action)
+{
+	switch (action)
+	{
+	case InputAction::MoveLeft: moveLeft(); break;
+	case InputAction::MoveRight: moveRight(); break;
+	case InputAction::RotateClockwise: rotateClockwise(); break;
+	case InputAction::RotateCounterClockwise: rotateCounterClockwise(); break;
+	case InputAction::SoftDropOn: setSoftDrop(true); break;
+	case InputAction::SoftDropOff: setSoftDrop(false); break;
+	case InputAction::HardDrop: hardDrop(); break;
+	case InputAction::Hold: hold(); break;
+	default: break;
+	}
+}
+
+uint64_t Game::getChecksum() const
+{
+	// FNV-1a over every field that affects what happens next
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](uint64_t value)
+	{
+		for (int i = 0; i < 8; i++, value >>= 8)
+			hash = (hash ^ (value & 0xFF)) * 1099511628211ull;
+	};
+
+	for (int y = 0; y < Board::kHeight; y++)
+	{
+		mix(m_board.getRow(y));
+		for (int p = 0; p < Board::kColorPlanes; p++)
+			mix(m_board.getColorPlane(p, y));
+	}
+
+	mix((uint64_t)m_piece.type);
+	mix((uint64_t)m_piece.rotation);
+	mix((uint64_t)m_piece.x);
+	mix((uint64_t)m_piece.y);
+	mix((uint64_t)m_held);
+	mix(m_canHold);
+	for (int i = 0; i < kPreviewCount; i++)
+		mix((uint64_t)getPreview(i));
+
+	mix((uint64_t)m_gravityMicros);
+	mix((uint64_t)m_lockMicros);
+	mix((uint64_t)m_lockResets);
+	mix(m_softDrop);
+	mix(m_tickCount);
+	mix(m_score);
+	mix((uint64_t)m_lines);
+	mix((uint64_t)m_piecesPlaced);
+	mix(m_gameOver);
+	return hash;
+}
+
+int Game::getGhostY() const
+{
+	return m_piece.y + m_board.dropDistance(m_piece.type, m_piece.rotation, m_piece.x, m_piece.y);
+}
+
+bool Game::tryMove(int dx, int dy)
+{
+	if (m_gameOver || !m_board.fits(m_piece.type, m_piece.rotation, m_piece.x + dx, m_piece.y + dy))
+		return false;
+
+	m_piece.x += dx;
+	m_piece.y += dy;
+	if (dx != 0)
+		onPieceMoved();
+	return true;
+}
+
+bool Game::tryRotate(bool clockwise)
+{
+	if (m_gameOver)
+		return false;
+
+	const int rotation = (m_piece.rotation + (clockwise ? 1 : 3)) & 3;
+	const KickOffset* kicks = getKicks(m_piece.type, m_piece.rotation, clockwise);
+	for (int i = 0; i < kKickCount; i++)
+	{
+		const int x = m_piece.x + kicks[i].x;
+		const int y = m_piece.y + kicks[i].y;
+		if (m_board.fits(m_piece.type, rotation, x, y))
+		{
+			m_piece.rotation = rotation;
+			m_piece.x = x;
+			m_piece.y = y;
+			onPieceMoved();
+			return true;
+		}
+	}
+	return false;
+}
+
+void Game::onPieceMoved()
+{
+	// Moving a grounded piece restarts the lock delay a limited number of times
+	if (m_lockMicros > 0 && m_lockResets < kMaxLockResets)
+	{
+		m_lockMicros = 0;
+		m_lockResets++;
+	}
+}
+
+bool Game::isGrounded() const
+{
+	return !m_board.fits(m_piece.type, m_piece.rotation, m_piece.x, m_piece.y + 1);
+}
+
+void Game::spawn(PieceType type)
+{
+	m_piece = { type, 0, kSpawnX, kSpawnY };
+	m_gravityMicros = 0;
+	m_lockMicros = 0;
+	m_lockResets = 0;
+
+	if (!m_board.fits(type, 0, kSpawnX, kSpawnY))
+		m_gameOver = true;
+}
+
+PieceType Game::nextFromQueue()
+{
+	const PieceType type = m_preview[m_previewHead];
+	m_preview[m_previewHead] = m_randomizer.next();
+	m_previewHead = (m_previewHead + 1) % kPreviewCount;
+	return type;
+}
+
+void Game::lockPiece(int dropDistance)
+{
+	const PieceMask& mask = getPieceMask(m_piece.type, m_piece.rotation);
+	m_board.place(m_piece.type, m_piece.rotation, m_piece.x, m_piece.y);
+	m_piecesPlaced++;
+	m_lastLock = { m_piece, 0, dropDistance };
+
+	// Lock out: the whole piece came to rest above the visible field
+	if (m_piece.y + mask.maxY < Board::kHiddenRows)
+	{
+		m_gameOver = true;
+		return;
+	}
+
+	const int cleared = m_board.clearLines(&m_lastLock.clearedRows);
+	if (cleared > 0)
+	{
+		m_score += (uint64_t)kLineScores[cleared] * m_level;
+		m_lines += cleared;
+		m_level = m_lines / 10 + 1;
+	}
+
+	m_canHold = true;
+	spawn(nextFromQueue());
+}
+
+int Game::getMicrosPerRow() const
+{
+	const int index = m_level - 1 < kLevelCount ? m_level - 1 : kLevelCount - 1;
+	return kMillisPerRow[index] * 1000;
+}
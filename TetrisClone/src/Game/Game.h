@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include "Board.h"
+#include "Randomizer.h"
+#include "Input.h"
+
+struct ActivePiece
+{
+	PieceType type;
+	int rotation;
+	int x;
+	int y;
+};
+
+// What the most recent lock did, for effects. Bit y of clearedRows is set when board row y was full.
+struct LockEvent
+{
+	ActivePiece piece;
+	uint32_t clearedRows;
+	// Rows the piece fell in a hard drop, 0 when gravity locked it
+	int dropDistance;
+};
+
+// Headless game state. Everything is integer arithmetic advanced one fixed tick at a time,
+// so it runs without a GL context and gives the same result for the same seed and inputs.
+class Game
+{
+public:
+	static constexpr int kPreviewCount = 5;
+	static constexpr int kSpawnX = 3;
+	static constexpr int kSpawnY = Board::kHiddenRows - 2;
+	static constexpr int kLockDelayMicros = 500000;
+	static constexpr int kMaxLockResets = 15;
+	static constexpr int kSoftDropFactor = 20;
+	// Points for clearing 0 to 4 lines at once, multiplied by the level
+	static constexpr int kLineScores[5] = { 0, 100, 300, 500, 800 };
+
+	explicit Game(uint32_t seed = 0, int tickRate = 60);
+
+	void reset(uint32_t seed);
+	void tick();
+
+	bool moveLeft();
+	bool moveRight();
+	bool rotateClockwise();
+	bool rotateCounterClockwise();
+	void setSoftDrop(bool enabled);
+	void hardDrop();
+	bool hold();
+	void apply(InputAction action);
+
+	inline const Board& getBoard() const { return m_board; }
+	inline const ActivePiece& getActivePiece() const { return m_piece; }
+	inline const ActivePiece& getPreviousPiece() const { return m_previousPiece; }
+	inline PieceType getHeldPiece() const { return m_held; }
+	inline bool canHold() const { return m_canHold; }
+	inline PieceType getPreview(int index) const { return m_preview[(m_previewHead + index) % kPreviewCount]; }
+	int getGhostY() const;
+	// Only the latest lock is kept; compare getPiecesPlaced between reads to tell whether it is new
+	inline const LockEvent& getLastLock() const { return m_lastLock; }
+
+	inline int getTickRate() const { return m_tickRate; }
+	inline uint64_t getTickCount() const { return m_tickCount; }
+	inline uint64_t getScore() const { return m_score; }
+	inline int getLines() const { return m_lines; }
+	inline int getLevel() const { return m_level; }
+	inline int getPiecesPlaced() const { return m_piecesPlaced; }
+	inline bool isGameOver() const { return m_gameOver; }
+
+	// Hash of the whole simulation state, for checking that a replay ended where the recording did
+	uint64_t getChecksum() const;
+
+private:
+	bool tryMove(int dx, int dy);
+	bool tryRotate(bool clockwise);
+	void onPieceMoved();
+	bool isGrounded() const;
+	void spawn(PieceType type);
+	PieceType nextFromQueue();
+	void lockPiece(int dropDistance = 0);
+	int getMicrosPerRow() const;
+
+private:
+	Board m_board;
+	Randomizer m_randomizer;
+	ActivePiece m_piece;
+	ActivePiece m_previousPiece;
+	LockEvent m_lastLock;
+	PieceType m_held;
+	bool m_canHold;
+	PieceType m_preview[kPreviewCount];
+	int m_previewHead;
+
+	int m_tickRate;
+	int m_microsPerTick;
+	int m_gravityMicros;
+	int m_lockMicros;
+	int m_lockResets;
+	bool m_softDrop;
+
+	uint64_t m_tickCount;
+	uint64_t m_score;
+	int m_lines;
+	int m_level;
+	int m_piecesPlaced;
+	bool m_gameOver;
+};
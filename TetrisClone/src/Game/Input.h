@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+class Game;
+
+// Everything a player can do to a game. Inputs are applied between ticks, so a stream of
+// (tick, action) pairs plus the seed reproduces a game exactly.
+enum class InputAction : uint8_t
+{
+	MoveLeft,
+	MoveRight,
+	RotateClockwise,
+	RotateCounterClockwise,
+	SoftDropOn,
+	SoftDropOff,
+	HardDrop,
+	Hold,
+	Count
+};
+
+// Feeds actions into a game. update is called before every tick with the game's current tick count.
+class InputSource
+{
+public:
+	virtual ~InputSource() {}
+
+	virtual void update(Game& game) = 0;
+	// True once there is nothing more to feed, such as at the end of a replay
+	virtual bool isFinished(const Game& game) const { return false; }
+
+	// Steady clock nanoseconds at which the coming tick ends, set by loops running in real time
+	virtual void setTickTime(uint64_t nanos) {}
+	// Applies input that arrived since the last tick without waiting for the next one, just before
+	// a frame is drawn. Only sources fed by a person have anything to do here.
+	virtual void latch(Game& game) {}
+};
\ No newline at end of file
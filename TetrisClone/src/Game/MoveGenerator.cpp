@@ -0,0 +1,218 @@
+#include "MoveGenerator.h"
+#include "Game.h"
+#include <cstring>
+
+namespace
+{
+	// Rotation states that share their shape with an earlier one, and the offset between the two
+	struct ShapeAlias
+	{
+		uint8_t rotation;
+		int8_t dx;
+		int8_t dy;
+	};
+
+	struct ShapeAliasTable
+	{
+		ShapeAlias aliases[kPieceTypeCount][kRotationCount];
+
+		ShapeAliasTable()
+		{
+			for (int type = 0; type < kPieceTypeCount; type++)
+			{
+				for (int rotation = 0; rotation < kRotationCount; rotation++)
+				{
+					const PieceMask& mask = getPieceMask((PieceType)type, rotation);
+					aliases[type][rotation] = { (uint8_t)rotation, 0, 0 };
+					for (int previous = 0; previous < rotation; previous++)
+					{
+						const PieceMask& other = getPieceMask((PieceType)type, previous);
+						if (isSameShape(mask, other))
+						{
+							aliases[type][rotation] = { (uint8_t)previous, (int8_t)(mask.minX - other.minX), (int8_t)(mask.minY - other.minY) };
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		// Same cells once both masks are moved into their top left corner
+		static bool isSameShape(const PieceMask& a, const PieceMask& b)
+		{
+			if (a.maxX - a.minX != b.maxX - b.minX || a.maxY - a.minY != b.maxY - b.minY)
+				return false;
+			for (int r = 0; r <= a.maxY - a.minY; r++)
+			{
+				if ((a.rows[a.minY + r] >> a.minX) != (b.rows[b.minY + r] >> b.minX))
+					return false;
+			}
+			return true;
+		}
+	};
+
+	const ShapeAliasTable s_shapeAliases;
+
+	constexpr int kNoParent = 0xFFFF;
+
+	inline int encodeState(int rotation, int x, int y)
+	{
+		return (rotation * MoveGenerator::kColumns + x + 3) * MoveGenerator::kRows + y + 3;
+	}
+
+	inline void decodeState(int state, int& rotation, int& x, int& y)
+	{
+		y = state % MoveGenerator::kRows - 3;
+		state /= MoveGenerator::kRows;
+		x = state % MoveGenerator::kColumns - 3;
+		rotation = state / MoveGenerator::kColumns;
+	}
+
+	// Breadth first search over piece positions. Each state records how it was first reached, so the
+	// moves to any placement can be read back from the parents. Stops early once target is reached.
+	struct Search
+	{
+		uint16_t queue[MoveGenerator::kStateCount];
+		uint16_t parent[MoveGenerator::kStateCount];
+		InputAction move[MoveGenerator::kStateCount];
+		// Visited states, plus a second map over the aliased rotation for placements already reported
+		uint8_t visited[MoveGenerator::kStateCount];
+		uint8_t placed[MoveGenerator::kStateCount];
+
+		int run(const Board& board, PieceType type, int rotation, int x, int y, Placement* placements, int target)
+		{
+			memset(visited, 0, sizeof(visited));
+			memset(placed, 0, sizeof(placed));
+
+			int count = 0;
+			if (!board.fits(type, rotation, x, y))
+				return count;
+
+			int head = 0;
+			int tail = 0;
+			const int start = encodeState(rotation, x, y);
+			visited[start] = 1;
+			parent[start] = kNoParent;
+			queue[tail++] = (uint16_t)start;
+
+			auto visit = [&](int from, InputAction action, int r, int nx, int ny)
+			{
+				const int state = encodeState(r, nx, ny);
+				if (visited[state])
+					return;
+				visited[state] = 1;
+				parent[state] = (uint16_t)from;
+				move[state] = action;
+				queue[tail++] = (uint16_t)state;
+			};
+
+			while (head < tail)
+			{
+				const int state = queue[head++];
+				if (state == target)
+					return count;
+
+				int r, px, py;
+				decodeState(state, r, px, py);
+
+				if (board.fits(type, r, px - 1, py))
+					visit(state, InputAction::MoveLeft, r, px - 1, py);
+				if (board.fits(type, r, px + 1, py))
+					visit(state, InputAction::MoveRight, r, px + 1, py);
+
+				for (int direction = 0; direction < 2; direction++)
+				{
+					const bool clockwise = direction == 0;
+					const int rotated = (r + (clockwise ? 1 : 3)) & 3;
+					const KickOffset* kicks = getKicks(type, r, clockwise);
+					for (int i = 0; i < kKickCount; i++)
+					{
+						if (board.fits(type, rotated, px + kicks[i].x, py + kicks[i].y))
+						{
+							visit(state, clockwise ? InputAction::RotateClockwise : InputAction::RotateCounterClockwise, rotated, px + kicks[i].x, py + kicks[i].y);
+							break;
+						}
+					}
+				}
+
+				const int distance = board.dropDistance(type, r, px, py);
+				if (distance > 0)
+				{
+					visit(state, InputAction::SoftDropOn, r, px, py + distance);
+					continue;
+				}
+
+				// Resting on something, so the piece can lock here
+				if (placements)
+				{
+					const ShapeAlias& alias = s_shapeAliases.aliases[(int)type][r];
+					const int key = encodeState(alias.rotation, px + alias.dx, py + alias.dy);
+					if (!placed[key])
+					{
+						placed[key] = 1;
+						placements[count++] = { (uint8_t)r, (int8_t)px, (int8_t)py };
+					}
+				}
+			}
+			return count;
+		}
+	};
+
+	thread_local Search t_search;
+}
+
+int MoveGenerator::generate(const Board& board, PieceType type, int rotation, int x, int y, Placement* placements)
+{
+	return t_search.run(board, type, rotation, x, y, placements, -1);
+}
+
+int MoveGenerator::findPath(const Board& board, PieceType type, int rotation, int x, int y, const Placement& target, InputAction* path)
+{
+	if (!board.fits(type, target.rotation, target.x, target.y))
+		return -1;
+
+	const int goal = encodeState(target.rotation, target.x, target.y);
+	Search& search = t_search;
+	search.run(board, type, rotation, x, y, nullptr, goal);
+	if (!search.visited[goal])
+		return -1;
+
+	// A final drop is left off, locking with a hard drop lands the piece in the same place
+	int last = goal;
+	if (search.parent[last] != kNoParent && search.move[last] == InputAction::SoftDropOn)
+		last = search.parent[last];
+
+	int length = 0;
+	for (int state = last; search.parent[state] != kNoParent; state = search.parent[state])
+		length++;
+	if (length > kMaxPathLength)
+		return -1;
+
+	int index = length;
+	for (int state = last; search.parent[state] != kNoParent; state = search.parent[state])
+		path[--index] = search.move[state];
+	return length;
+}
+
+void MoveGenerator::apply(Game& game, const Placement& placement)
+{
+	const ActivePiece& piece = game.getActivePiece();
+	InputAction path[kMaxPathLength];
+	const int length = findPath(game.getBoard(), piece.type, piece.rotation, piece.x, piece.y, placement, path);
+
+	for (int i = 0; i < length && !game.isGameOver(); i++)
+	{
+		if (path[i] != InputAction::SoftDropOn)
+		{
+			game.apply(path[i]);
+			continue;
+		}
+
+		game.apply(InputAction::SoftDropOn);
+		while (!game.isGameOver() && game.getBoard().fits(piece.type, piece.rotation, piece.x, piece.y + 1))
+			game.tick();
+		game.apply(InputAction::SoftDropOff);
+	}
+
+	game.apply(InputAction::HardDrop);
+}
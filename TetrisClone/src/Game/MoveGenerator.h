@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include "Board.h"
+#include "Input.h"
+
+class Game;
+
+// A resting position for a piece: its rotation and where it locks
+struct Placement
+{
+	uint8_t rotation;
+	int8_t x;
+	int8_t y;
+};
+
+// Enumerates every position a piece can lock in by shifting, rotating with the game's wall kicks
+// and soft dropping, so tucks under overhangs and kicked spins are found along with plain drops.
+// Placements covering the same cells in a different rotation state are only reported once.
+class MoveGenerator
+{
+public:
+	// Pieces sit at x -3..9 and y -3..kHeight-1
+	static constexpr int kColumns = Board::kWidth + 3;
+	static constexpr int kRows = Board::kHeight + 3;
+	static constexpr int kStateCount = kRotationCount * kColumns * kRows;
+	// A column can hold at most one resting spot per two rows
+	static constexpr int kMaxPlacements = kRotationCount * kColumns * (Board::kHeight / 2 + 1);
+	static constexpr int kMaxPathLength = 64;
+
+	// Fills placements and returns how many there are, searching from the given piece position
+	static int generate(const Board& board, PieceType type, int rotation, int x, int y, Placement* placements);
+
+	// Writes the shortest list of moves from the position to the placement, before the hard drop that locks
+	// it, and returns its length or -1 when it cannot be reached. SoftDropOn in a path means holding soft
+	// drop until the piece lands.
+	static int findPath(const Board& board, PieceType type, int rotation, int x, int y, const Placement& target, InputAction* path);
+
+	// Steers the game's active piece into a placement and locks it there. Soft drops tick the game until the piece lands.
+	static void apply(Game& game, const Placement& placement);
+};
\ No newline at end of file
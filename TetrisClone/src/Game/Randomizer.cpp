@@ -0,0 +1,49 @@
+#include "Randomizer.h"
+
+void Randomizer::reset(uint32_t seed)
+{
+	m_seed = seed;
+
+	// Scramble the seed so that neighbouring seeds give unrelated sequences; xorshift needs a non-zero state
+	uint32_t z = seed + 0x9E3779B9u;
+	z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+	z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+	z ^= z >> 16;
+	m_state = z ? z : 0x6D2B79F5u;
+
+	m_index = kPieceTypeCount;
+}
+
+PieceType Randomizer::next()
+{
+	if (m_index >= kPieceTypeCount)
+		refill();
+	return m_bag[m_index++];
+}
+
+uint32_t Randomizer::nextRandom()
+{
+	uint32_t x = m_state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	m_state = x;
+	return x;
+}
+
+void Randomizer::refill()
+{
+	for (int i = 0; i < kPieceTypeCount; i++)
+		m_bag[i] = (PieceType)i;
+
+	// Fisher-Yates shuffle, mapping the random word onto [0, i] with a multiply instead of a modulo
+	for (int i = kPieceTypeCount - 1; i > 0; i--)
+	{
+		const int j = (int)(((uint64_t)nextRandom() * (uint64_t)(i + 1)) >> 32);
+		PieceType tmp = m_bag[i];
+		m_bag[i] = m_bag[j];
+		m_bag[j] = tmp;
+	}
+
+	m_index = 0;
+}
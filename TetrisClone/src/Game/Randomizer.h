@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include "Tetromino.h"
+
+// 7-bag piece generator driven by a small integer PRNG so sequences are reproducible from a seed
+class Randomizer
+{
+public:
+	explicit Randomizer(uint32_t seed = 0) { reset(seed); }
+
+	void reset(uint32_t seed);
+	PieceType next();
+
+	inline uint32_t getSeed() const { return m_seed; }
+
+private:
+	uint32_t nextRandom();
+	void refill();
+
+private:
+	uint32_t m_seed;
+	uint32_t m_state;
+	PieceType m_bag[kPieceTypeCount];
+	int m_index;
+};
@@ -0,0 +1,152 @@
+#include "Replay.h"
+#include "Game.h"
+#include <iostream>
+#include <iterator>
+
+InputRecorder::InputRecorder(const char* filePath, uint32_t seed, int tickRate)
+	: m_file(filePath, std::ios::binary | std::ios::trunc), m_lastTick(0), m_finished(false)
+{
+	if (!m_file)
+	{
+		std::cerr << "Failed to open replay file " << filePath << " for writing" << std::endl;
+		return;
+	}
+
+	for (int i = 0; i < 4; i++)
+		m_file.put((char)((Replay::kMagic >> (i * 8)) & 0xFF));
+	m_file.put((char)Replay::kVersion);
+	writeVarint(seed);
+	writeVarint((uint64_t)tickRate);
+}
+
+InputRecorder::~InputRecorder()
+{
+	m_file.flush();
+}
+
+void InputRecorder::record(uint64_t tick, InputAction action)
+{
+	if (!isOpen() || m_finished)
+		return;
+
+	writeVarint((tick - m_lastTick) << Replay::kActionBits | (uint64_t)action);
+	m_lastTick = tick;
+}
+
+void InputRecorder::finish(const Game& game)
+{
+	if (!isOpen() || m_finished)
+		return;
+
+	writeVarint((game.getTickCount() - m_lastTick) << Replay::kActionBits | Replay::kEndMarker);
+	uint64_t checksum = game.getChecksum();
+	for (int i = 0; i < 8; i++, checksum >>= 8)
+		m_file.put((char)(checksum & 0xFF));
+	m_file.flush();
+	m_finished = true;
+}
+
+void InputRecorder::writeVarint(uint64_t value)
+{
+	// Seven bits per byte, low bits first, with the top bit set on every byte but the last
+	while (value >= 0x80)
+	{
+		m_file.put((char)((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	m_file.put((char)value);
+}
+
+InputReplayer::InputReplayer(const char* filePath)
+	: m_cursor(0), m_valid(false), m_seed(0), m_tickRate(0), m_hasNext(false), m_nextTick(0),
+	m_nextAction(InputAction::Count), m_inputCount(0), m_ended(false), m_endTick(0), m_checksum(0)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Failed to open replay file " << filePath << std::endl;
+		return;
+	}
+	m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	uint32_t magic = 0;
+	if (m_data.size() < sizeof(magic) + 1)
+		return;
+	for (int i = 0; i < 4; i++)
+		magic |= (uint32_t)m_data[i] << (i * 8);
+	if (magic != Replay::kMagic || m_data[4] != Replay::kVersion)
+	{
+		std::cerr << filePath << " is not a replay this version can play" << std::endl;
+		return;
+	}
+	m_cursor = 5;
+
+	uint64_t seed, tickRate;
+	if (!readVarint(seed) || !readVarint(tickRate) || tickRate == 0)
+		return;
+	m_seed = (uint32_t)seed;
+	m_tickRate = (int)tickRate;
+	m_valid = true;
+
+	readNext();
+}
+
+void InputReplayer::update(Game& game)
+{
+	while (m_hasNext && m_nextTick <= game.getTickCount())
+	{
+		game.apply(m_nextAction);
+		m_inputCount++;
+		readNext();
+	}
+}
+
+bool InputReplayer::isFinished(const Game& game) const
+{
+	if (!m_valid || game.isGameOver())
+		return true;
+	if (m_hasNext)
+		return false;
+	return !m_ended || game.getTickCount() >= m_endTick;
+}
+
+bool InputReplayer::readVarint(uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && m_cursor < m_data.size(); shift += 7)
+	{
+		const uint8_t byte = m_data[m_cursor++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+void InputReplayer::readNext()
+{
+	m_hasNext = false;
+
+	uint64_t word;
+	if (!readVarint(word))
+		return;
+
+	const uint64_t tick = m_nextTick + (word >> Replay::kActionBits);
+	const uint8_t action = (uint8_t)(word & Replay::kEndMarker);
+	if (action == Replay::kEndMarker)
+	{
+		if (m_cursor + 8 > m_data.size())
+			return;
+
+		m_checksum = 0;
+		for (int i = 0; i < 8; i++)
+			m_checksum |= (uint64_t)m_data[m_cursor++] << (i * 8);
+		m_endTick = tick;
+		m_ended = true;
+		return;
+	}
+
+	m_nextTick = tick;
+	m_nextAction = (InputAction)action;
+	m_hasNext = action < (uint8_t)InputAction::Count;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "Input.h"
+
+// Replay files start with "TRPL", a version byte and the seed and tick rate as varints. Each
+// input follows as one varint holding the ticks since the previous input shifted left by four,
+// with the action in the low four bits. The stream ends with an end marker in the same form,
+// carrying the final tick, and then the final state checksum as eight little endian bytes.
+namespace Replay
+{
+	constexpr uint32_t kMagic = 0x4C505254; // "TRPL"
+	constexpr uint8_t kVersion = 1;
+	constexpr int kActionBits = 4;
+	constexpr uint8_t kEndMarker = (1 << kActionBits) - 1;
+
+	static_assert((int)InputAction::Count <= kEndMarker, "Actions must fit below the end marker");
+}
+
+// Streams inputs to a replay file as they are applied. A file cut short by a crash still
+// replays up to the last input written.
+class InputRecorder
+{
+public:
+	InputRecorder(const char* filePath, uint32_t seed, int tickRate);
+	~InputRecorder();
+
+	inline bool isOpen() const { return m_file.is_open(); }
+
+	void record(uint64_t tick, InputAction action);
+	// Writes the end marker with the game's final tick and checksum. Nothing is recorded after.
+	void finish(const Game& game);
+
+private:
+	void writeVarint(uint64_t value);
+
+private:
+	std::ofstream m_file;
+	uint64_t m_lastTick;
+	bool m_finished;
+};
+
+// Plays a replay file back into a game, applying each input at the tick it was recorded on
+class InputReplayer : public InputSource
+{
+public:
+	explicit InputReplayer(const char* filePath);
+
+	inline bool isValid() const { return m_valid; }
+	inline uint32_t getSeed() const { return m_seed; }
+	inline int getTickRate() const { return m_tickRate; }
+	inline bool hasChecksum() const { return m_ended; }
+	inline uint64_t getChecksum() const { return m_checksum; }
+	inline uint64_t getInputCount() const { return m_inputCount; }
+
+	void update(Game& game) override;
+	bool isFinished(const Game& game) const override;
+
+private:
+	bool readVarint(uint64_t& value);
+	// Decodes the next input, or the end marker, into m_nextTick and m_nextAction
+	void readNext();
+
+private:
+	std::vector<uint8_t> m_data;
+	size_t m_cursor;
+	bool m_valid;
+	uint32_t m_seed;
+	int m_tickRate;
+
+	bool m_hasNext;
+	uint64_t m_nextTick;
+	InputAction m_nextAction;
+	uint64_t m_inputCount;
+
+	bool m_ended;
+	uint64_t m_endTick;
+	uint64_t m_checksum;
+};
\ No newline at end of file
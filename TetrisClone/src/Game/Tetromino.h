@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+
+enum class PieceType : uint8_t
+{
+	I, J, L, O, S, T, Z, None
+};
+
+constexpr int kPieceTypeCount = 7;
+constexpr int kRotationCount = 4;
+constexpr int kKickCount = 5;
+
+// A piece rotation as four rows of a 4x4 box, top row first. Bit c is box column c.
+struct PieceMask
+{
+	uint16_t rows[4];
+	int8_t minX, maxX;
+	int8_t minY, maxY;
+};
+
+struct KickOffset
+{
+	int8_t x, y;
+};
+
+// Builds a rotation mask from a 16 character picture of the 4x4 box, 'X' marking a cell
+constexpr PieceMask makePieceMask(const char* picture)
+{
+	PieceMask mask = { { 0, 0, 0, 0 }, 4, -1, 4, -1 };
+	for (int y = 0; y < 4; y++)
+	{
+		for (int x = 0; x < 4; x++)
+		{
+			if (picture[y * 4 + x] != 'X')
+				continue;
+
+			mask.rows[y] |= (uint16_t)(1u << x);
+			if (x < mask.minX) mask.minX = (int8_t)x;
+			if (x > mask.maxX) mask.maxX = (int8_t)x;
+			if (y < mask.minY) mask.minY = (int8_t)y;
+			if (y > mask.maxY) mask.maxY = (int8_t)y;
+		}
+	}
+	return mask;
+}
+
+// SRS rotation states 0, R, 2, L for every piece
+inline constexpr PieceMask kPieceMasks[kPieceTypeCount][kRotationCount] =
+{
+	{ // I
+		makePieceMask("....XXXX........"),
+		makePieceMask("..X...X...X...X."),
+		makePieceMask("........XXXX...."),
+		makePieceMask(".X...X...X...X..")
+	},
+	{ // J
+		makePieceMask("X...XXX........."),
+		makePieceMask(".XX..X...X......"),
+		makePieceMask("....XXX...X....."),
+		makePieceMask(".X...X..XX......")
+	},
+	{ // L
+		makePieceMask("..X.XXX........."),
+		makePieceMask(".X...X...XX....."),
+		makePieceMask("....XXX.X......."),
+		makePieceMask("XX...X...X......")
+	},
+	{ // O
+		makePieceMask(".XX..XX........."),
+		makePieceMask(".XX..XX........."),
+		makePieceMask(".XX..XX........."),
+		makePieceMask(".XX..XX.........")
+	},
+	{ // S
+		makePieceMask(".XX.XX.........."),
+		makePieceMask(".X...XX...X....."),
+		makePieceMask(".....XX.XX......"),
+		makePieceMask("X...XX...X......")
+	},
+	{ // T
+		makePieceMask(".X..XXX........."),
+		makePieceMask(".X...XX..X......"),
+		makePieceMask("....XXX..X......"),
+		makePieceMask(".X..XX...X......")
+	},
+	{ // Z
+		makePieceMask("XX...XX........."),
+		makePieceMask("..X..XX..X......"),
+		makePieceMask("....XX...XX....."),
+		makePieceMask(".X..XX..X.......")
+	}
+};
+
+// SRS wall kicks indexed by [from rotation][direction], direction 0 being clockwise.
+// Offsets are in board space where y grows downward.
+inline constexpr KickOffset kKicksJLSTZ[kRotationCount][2][kKickCount] =
+{
+	{ { { 0, 0 }, { -1, 0 }, { -1, -1 }, { 0, 2 }, { -1, 2 } },    // 0 -> R
+	  { { 0, 0 }, { 1, 0 }, { 1, -1 }, { 0, 2 }, { 1, 2 } } },      // 0 -> L
+	{ { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, -2 }, { 1, -2 } },       // R -> 2
+	  { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, -2 }, { 1, -2 } } },     // R -> 0
+	{ { { 0, 0 }, { 1, 0 }, { 1, -1 }, { 0, 2 }, { 1, 2 } },        // 2 -> L
+	  { { 0, 0 }, { -1, 0 }, { -1, -1 }, { 0, 2 }, { -1, 2 } } },   // 2 -> R
+	{ { { 0, 0 }, { -1, 0 }, { -1, 1 }, { 0, -2 }, { -1, -2 } },    // L -> 0
+	  { { 0, 0 }, { -1, 0 }, { -1, 1 }, { 0, -2 }, { -1, -2 } } }   // L -> 2
+};
+
+inline constexpr KickOffset kKicksI[kRotationCount][2][kKickCount] =
+{
+	{ { { 0, 0 }, { -2, 0 }, { 1, 0 }, { -2, 1 }, { 1, -2 } },      // 0 -> R
+	  { { 0, 0 }, { -1, 0 }, { 2, 0 }, { -1, -2 }, { 2, 1 } } },    // 0 -> L
+	{ { { 0, 0 }, { -1, 0 }, { 2, 0 }, { -1, -2 }, { 2, 1 } },      // R -> 2
+	  { { 0, 0 }, { 2, 0 }, { -1, 0 }, { 2, -1 }, { -1, 2 } } },    // R -> 0
+	{ { { 0, 0 }, { 2, 0 }, { -1, 0 }, { 2, -1 }, { -1, 2 } },      // 2 -> L
+	  { { 0, 0 }, { 1, 0 }, { -2, 0 }, { 1, 2 }, { -2, -1 } } },    // 2 -> R
+	{ { { 0, 0 }, { 1, 0 }, { -2, 0 }, { 1, 2 }, { -2, -1 } },      // L -> 0
+	  { { 0, 0 }, { -2, 0 }, { 1, 0 }, { -2, 1 }, { 1, -2 } } }     // L -> 2
+};
+
+constexpr const PieceMask& getPieceMask(PieceType type, int rotation)
+{
+	return kPieceMasks[(int)type][rotation & 3];
+}
+
+constexpr const KickOffset* getKicks(PieceType type, int rotation, bool clockwise)
+{
+	if (type == PieceType::I)
+		return kKicksI[rotation & 3][clockwise ? 0 : 1];
+	return kKicksJLSTZ[rotation & 3][clockwise ? 0 : 1];
+}
@@ -0,0 +1,262 @@
+#include "AssetLoader.h"
+#include "Shader.h"
+#include "ShaderLibrary.h"
+#include "Font.h"
+#include "TextureAtlas.h"
+#include "Core/MappedFile.h"
+#include "Core/AssetArchive.h"
+#include "Core/Profiler.h"
+#include <chrono>
+#include <iostream>
+
+AssetLoader::AssetLoader(ShaderLibrary& shaders, int workerCount)
+	: m_shaders(shaders), m_archive(nullptr), m_stopping(false), m_requested(0), m_finished(0), m_runStart(0), m_finishedFromArchive(0)
+{
+	if (workerCount <= 0)
+	{
+		const int hardware = (int)std::thread::hardware_concurrency() - 1;
+		workerCount = hardware < 1 ? 1 : (hardware > 4 ? 4 : hardware);
+	}
+
+	m_results = new SpscQueue<Decoded*, kResultCapacity>[workerCount];
+	for (int i = 0; i < workerCount; i++)
+		m_workers.emplace_back(&AssetLoader::workerMain, this, i);
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		// Set under the lock so a worker cannot check it and then miss the wake up
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& worker : m_workers)
+		worker.join();
+
+	// Anything decoded but never uploaded is thrown away
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		Decoded* decoded;
+		while (m_results[i].tryPop(decoded))
+			m_uploads.push_back(decoded);
+	}
+	for (Decoded* decoded : m_uploads)
+	{
+		delete[] decoded->bytes;
+		delete decoded;
+	}
+	delete[] m_results;
+
+	for (Font* font : m_fonts)
+		delete font;
+	for (AssetSlot* slot : m_slots)
+		delete slot;
+}
+
+AssetHandle<Shader> AssetLoader::loadShader(const char* filePath)
+{
+	return AssetHandle<Shader>(request(AssetType::Shader, filePath, nullptr));
+}
+
+AssetHandle<Font> AssetLoader::loadFont(TextureAtlas& atlas)
+{
+	return AssetHandle<Font>(request(AssetType::Font, "", &atlas));
+}
+
+AssetSlot* AssetLoader::request(AssetType type, const char* path, TextureAtlas* atlas)
+{
+	AssetSlot* slot = new AssetSlot();
+	slot->state.store(AssetState::Queued, std::memory_order_relaxed);
+	slot->asset = nullptr;
+	m_slots.push_back(slot);
+	if (isIdle())
+	{
+		m_loadStart = std::chrono::steady_clock::now();
+		m_runStart = m_requested;
+		m_finishedFromArchive = 0;
+	}
+	m_requested++;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back({ type, path, atlas, slot });
+	}
+	m_wake.notify_one();
+	return slot;
+}
+
+int AssetLoader::update(double budgetMs)
+{
+	PROFILE_SCOPE("Asset Uploads");
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		Decoded* decoded;
+		while (m_results[i].tryPop(decoded))
+			m_uploads.push_back(decoded);
+	}
+
+	// Uploads are not split, so one that is slow on its own can still run over the budget
+	const auto start = std::chrono::steady_clock::now();
+	size_t uploaded = 0;
+	while (uploaded < m_uploads.size())
+	{
+		upload(m_uploads[uploaded++]);
+
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		if (elapsed.count() >= budgetMs)
+			break;
+	}
+
+	m_uploads.erase(m_uploads.begin(), m_uploads.begin() + uploaded);
+	return (int)uploaded;
+}
+
+void AssetLoader::workerMain(int worker)
+{
+	while (true)
+	{
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+			if (m_stopping)
+				return;
+
+			request = std::move(m_requests.front());
+			m_requests.pop_front();
+		}
+
+		Decoded* decoded = decode(request);
+
+		// The main thread drains the queue every frame, so a full one clears quickly
+		while (!m_results[worker].tryPush(decoded))
+		{
+			if (m_stopping)
+			{
+				delete[] decoded->bytes;
+				delete decoded;
+				return;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+AssetLoader::Decoded* AssetLoader::decode(const Request& request)
+{
+	PROFILE_SCOPE("Asset Decode");
+	const auto start = std::chrono::steady_clock::now();
+	request.slot->state.store(AssetState::Decoding, std::memory_order_release);
+
+	Decoded* decoded = new Decoded();
+	decoded->request = request;
+	decoded->succeeded = true;
+	decoded->fromArchive = false;
+	decoded->data = nullptr;
+	decoded->bytes = nullptr;
+
+	if (m_archive && decodeFromArchive(decoded))
+	{
+		decoded->fromArchive = true;
+	}
+	else if (request.type == AssetType::Shader)
+	{
+		const MappedFile file(request.path.c_str());
+		decoded->succeeded = file.isValid();
+		if (file.isValid())
+			decoded->text.assign((const char*)file.getData(), file.getSize());
+	}
+	else if (request.type == AssetType::Font)
+	{
+		decoded->bytes = new uint8_t[Font::kFieldBytes];
+		Font::bakeFields(decoded->bytes);
+		decoded->data = decoded->bytes;
+	}
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	decoded->decodeMs = elapsed.count();
+	request.slot->state.store(decoded->succeeded ? AssetState::Uploading : AssetState::Failed, std::memory_order_release);
+	return decoded;
+}
+
+bool AssetLoader::decodeFromArchive(Decoded* decoded)
+{
+	const Request& request = decoded->request;
+	const ArchiveEntry* entry = m_archive->find(request.type == AssetType::Font ? Font::kArchiveName : request.path.c_str());
+	if (!entry)
+		return false;
+
+	// Uncompressed entries are read in place from the mapping
+	const uint8_t* contents = m_archive->getStoredData(*entry);
+	if (m_archive->isCompressed(*entry))
+	{
+		decoded->bytes = new uint8_t[entry->size];
+		if (!m_archive->extract(*entry, decoded->bytes))
+		{
+			delete[] decoded->bytes;
+			decoded->bytes = nullptr;
+			return false;
+		}
+		contents = decoded->bytes;
+	}
+
+	if (request.type == AssetType::Shader)
+	{
+		decoded->text.assign((const char*)contents, entry->size);
+		delete[] decoded->bytes;
+		decoded->bytes = nullptr;
+		return true;
+	}
+
+	// A font packed for a different glyph set falls back to baking
+	decoded->data = Font::findPackedFields(contents, entry->size);
+	if (!decoded->data)
+	{
+		delete[] decoded->bytes;
+		decoded->bytes = nullptr;
+		return false;
+	}
+	return true;
+}
+
+void AssetLoader::upload(Decoded* decoded)
+{
+	const Request& request = decoded->request;
+	if (!decoded->succeeded)
+	{
+		std::cerr << "Failed to read " << request.path << std::endl;
+	}
+	else if (request.type == AssetType::Shader)
+	{
+		request.slot->asset = m_shaders.add(new Shader(request.path.c_str(), decoded->text));
+	}
+	else if (request.type == AssetType::Font)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		Font* font = new Font(*request.atlas, decoded->data);
+		request.atlas->upload();
+		m_fonts.push_back(font);
+		request.slot->asset = font;
+
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << "Loaded font in " << decoded->decodeMs << " ms on a worker and " << elapsed.count() << " ms on the main thread" << std::endl;
+	}
+
+	if (decoded->succeeded)
+		request.slot->state.store(AssetState::Ready, std::memory_order_release);
+	m_finished++;
+	if (decoded->fromArchive)
+		m_finishedFromArchive++;
+
+	if (isIdle())
+	{
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_loadStart;
+		std::cout << "Loaded " << m_requested - m_runStart << " assets in " << elapsed.count() << " ms, "
+			<< m_finishedFromArchive << " of them from the archive" << std::endl;
+	}
+
+	delete[] decoded->bytes;
+	delete decoded;
+}
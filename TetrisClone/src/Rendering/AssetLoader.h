@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Core/SpscQueue.h"
+
+class Shader;
+class ShaderLibrary;
+class Font;
+class TextureAtlas;
+class AssetArchive;
+
+enum class AssetState : uint8_t
+{
+	Queued, Decoding, Uploading, Ready, Failed
+};
+
+// Shared by a handle and the loader. Only the main thread marks an asset Ready, once it is uploaded.
+struct AssetSlot
+{
+	std::atomic<AssetState> state;
+	void* asset;
+};
+
+// Refers to an asset that may still be loading. get returns null until it is ready to use.
+template<typename T>
+class AssetHandle
+{
+public:
+	AssetHandle() : m_slot(nullptr) {}
+
+	inline AssetState getState() const { return m_slot ? m_slot->state.load(std::memory_order_acquire) : AssetState::Failed; }
+	inline bool isReady() const { return getState() == AssetState::Ready; }
+	inline T* get() const { return isReady() ? (T*)m_slot->asset : nullptr; }
+
+private:
+	friend class AssetLoader;
+	explicit AssetHandle(AssetSlot* slot) : m_slot(slot) {}
+
+	AssetSlot* m_slot;
+};
+
+// Loads assets without stalling the frame. Worker threads map each file and decode it, then pass
+// the result back through a lock-free queue of their own. update does the GL side on the main
+// thread and stops once the frame's time budget is spent, so a loading screen keeps drawing.
+class AssetLoader
+{
+public:
+	static constexpr size_t kResultCapacity = 64;
+
+	// 0 workers uses one less than the hardware threads, between 1 and 4
+	explicit AssetLoader(ShaderLibrary& shaders, int workerCount = 0);
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	// Assets found in the archive are read from it instead of from loose files. It must outlive the
+	// loader and be set before anything is requested.
+	inline void setArchive(const AssetArchive* archive) { m_archive = archive; }
+
+	// Built shaders are handed to the library, which owns and hot reloads them from then on
+	AssetHandle<Shader> loadShader(const char* filePath);
+	// The glyphs are added to the atlas and uploaded with it. The loader owns the font.
+	AssetHandle<Font> loadFont(TextureAtlas& atlas);
+
+	// Main thread only. Collects decoded assets and uploads them until budgetMs has passed, always
+	// finishing at least one that is waiting. Returns how many were uploaded.
+	int update(double budgetMs);
+
+	inline int getRequestedCount() const { return m_requested; }
+	inline int getFinishedCount() const { return m_finished; }
+	inline bool isIdle() const { return m_finished == m_requested; }
+
+private:
+	enum class AssetType : uint8_t
+	{
+		Shader, Font
+	};
+
+	struct Request
+	{
+		AssetType type;
+		std::string path;
+		TextureAtlas* atlas;
+		AssetSlot* slot;
+	};
+
+	// Made by a worker and consumed by update
+	struct Decoded
+	{
+		Request request;
+		bool succeeded;
+		bool fromArchive;
+		std::string text;
+		// What upload reads, either bytes or a view of the archive mapping that nothing had to copy
+		const uint8_t* data;
+		uint8_t* bytes;
+		double decodeMs;
+	};
+
+	AssetSlot* request(AssetType type, const char* path, TextureAtlas* atlas);
+	void workerMain(int worker);
+	Decoded* decode(const Request& request);
+	bool decodeFromArchive(Decoded* decoded);
+	void upload(Decoded* decoded);
+
+private:
+	ShaderLibrary& m_shaders;
+	const AssetArchive* m_archive;
+	std::vector<std::thread> m_workers;
+	// One per worker, so each has a single producer and the main thread is the single consumer
+	SpscQueue<Decoded*, kResultCapacity>* m_results;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<Request> m_requests;
+	std::atomic<bool> m_stopping;
+
+	// Main thread only
+	std::vector<AssetSlot*> m_slots;
+	std::vector<Font*> m_fonts;
+	std::vector<Decoded*> m_uploads;
+	int m_requested;
+	int m_finished;
+	int m_runStart;
+	int m_finishedFromArchive;
+	// When the current run of requests started, for reporting how long loading took
+	std::chrono::steady_clock::time_point m_loadStart;
+};
\ No newline at end of file
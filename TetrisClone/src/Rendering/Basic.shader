@@ -1,10 +1,27 @@
 #shader vertex
 #version 330 core
 
-layout(location = 0) in vec4 position;
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+layout(location = 3) in float texIndex;
+
+layout(std140) uniform Frame
+{
+   mat4 u_Projection;
+   vec4 u_Time;
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out float v_TexIndex;
+
 void main()
 {
-   gl_Position = position;
+   v_Color = color;
+   v_TexCoord = texCoord;
+   v_TexIndex = texIndex;
+   gl_Position = u_Projection * vec4(position, 0.0, 1.0);
 };
 
 #shader fragment
@@ -12,9 +29,24 @@ void main()
 
 layout(location = 0) out vec4 color;
 
-uniform vec4 u_Color;
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in float v_TexIndex;
+
+// Samplers default to unit 0, which is where the draw list binds the batch's texture
+uniform sampler2D u_Atlas;
 
 void main()
 {
-   color = u_Color;
+   // Index 0 is a flat colored quad, 1 samples the atlas and 2 draws a distance field glyph from it
+   if (v_TexIndex > 1.5)
+   {
+      float distance = texture(u_Atlas, v_TexCoord).a;
+      float width = fwidth(distance) * 0.75;
+      color = vec4(v_Color.rgb, v_Color.a * smoothstep(0.5 - width, 0.5 + width, distance));
+   }
+   else if (v_TexIndex > 0.5)
+      color = v_Color * texture(u_Atlas, v_TexCoord);
+   else
+      color = v_Color;
 };
\ No newline at end of file
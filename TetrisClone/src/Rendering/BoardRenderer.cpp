@@ -0,0 +1,120 @@
+#include "BoardRenderer.h"
+#include "VertexBufferLayout.h"
+#include "Shader.h"
+#include "DrawList.h"
+#include "Texture.h"
+#include "GL/glew.h"
+
+namespace
+{
+	constexpr UniformName kGridUniform("u_Grid");
+	constexpr UniformName kPaletteUniform("u_Palette");
+	constexpr UniformName kSkinRectUniform("u_SkinRect");
+}
+
+const float BoardRenderer::kPalette[kColorCount][4] =
+{
+	{ 0.08f, 0.08f, 0.10f, 1.0f },
+	{ 0.00f, 0.90f, 0.90f, 1.0f },
+	{ 0.10f, 0.20f, 0.95f, 1.0f },
+	{ 0.95f, 0.55f, 0.05f, 1.0f },
+	{ 0.95f, 0.90f, 0.05f, 1.0f },
+	{ 0.10f, 0.85f, 0.20f, 1.0f },
+	{ 0.65f, 0.15f, 0.85f, 1.0f },
+	{ 0.90f, 0.10f, 0.15f, 1.0f }
+};
+
+BoardRenderer::BoardRenderer(Shader& shader, DrawList& drawList, const Texture& atlas, const AtlasRegion& skin)
+	: m_shader(shader), m_drawList(drawList), m_atlas(atlas), m_skin(skin), m_shaderGeneration(~0u),
+	m_instanceBuffer(kCellCount * sizeof(uint32_t)), m_valid(false), m_bytesUploaded(0)
+{
+	float positions[] =
+	{
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		1.0f, 1.0f,
+		0.0f, 1.0f
+	};
+
+	unsigned int indices[] =
+	{
+		0, 1, 2,
+		2, 3, 0
+	};
+
+	m_quadBuffer = VertexBuffer(positions, 4 * 2 * sizeof(float));
+	VertexBufferLayout quadLayout;
+	quadLayout.push<float>(2);
+	m_vertexArray.addBuffer(m_quadBuffer, quadLayout);
+
+	VertexBufferLayout instanceLayout;
+	instanceLayout.push<unsigned int>(1, 1);
+	m_vertexArray.addBuffer(m_instanceBuffer, instanceLayout);
+
+	m_indexBuffer = IndexBuffer(indices, 6);
+	m_vertexArray.setIndexBuffer(m_indexBuffer);
+
+	m_vertexArray.unbind();
+	m_instanceBuffer.unbind();
+	m_indexBuffer.unbind();
+}
+
+void BoardRenderer::draw(const Board& board, float left, float top, float cellWidth, float cellHeight)
+{
+	m_bytesUploaded = 0;
+
+	// Upload each run of consecutive changed rows with a single sub data call
+	int runStart = -1;
+	for (int row = 0; row <= Board::kVisibleHeight; row++)
+	{
+		const bool dirty = row < Board::kVisibleHeight && updateRow(board, row);
+		if (dirty && runStart < 0)
+			runStart = row;
+
+		if (!dirty && runStart >= 0)
+		{
+			const unsigned int offset = runStart * Board::kWidth * sizeof(uint32_t);
+			const unsigned int size = (row - runStart) * Board::kWidth * sizeof(uint32_t);
+			m_instanceBuffer.setSubData(offset, m_instances + runStart * Board::kWidth, size);
+			m_bytesUploaded += size;
+			runStart = -1;
+		}
+	}
+	m_valid = true;
+
+	m_shader.Bind();
+
+	// The palette and skin never change, so they are only set again when a reload replaced the program
+	if (m_shaderGeneration != m_shader.GetGeneration())
+	{
+		m_shader.SetUniform4fv(kPaletteUniform, kColorCount, &kPalette[0][0]);
+		m_shader.SetUniform4f(kSkinRectUniform, m_skin.u0, m_skin.v0, m_skin.u1, m_skin.v1);
+		m_shaderGeneration = m_shader.GetGeneration();
+	}
+	m_shader.SetUniform4f(kGridUniform, left, top, cellWidth, cellHeight);
+
+	// Uniforms are program state, so values set now are still in place when the draw list runs
+	m_drawList.submit(RenderLayer::Board, m_shader.GetRendererID(), m_vertexArray.getRendererID(), m_atlas.getRendererID(),
+		6, 0, kCellCount);
+}
+
+bool BoardRenderer::updateRow(const Board& board, int row)
+{
+	const int y = row + Board::kHiddenRows;
+	uint16_t words[1 + Board::kColorPlanes];
+	words[0] = board.getRow(y);
+	for (int p = 0; p < Board::kColorPlanes; p++)
+		words[1 + p] = board.getColorPlane(p, y);
+
+	bool changed = !m_valid;
+	for (int i = 0; i < 1 + Board::kColorPlanes && !changed; i++)
+		changed = words[i] != m_uploadedRows[row][i];
+	if (!changed)
+		return false;
+
+	for (int i = 0; i < 1 + Board::kColorPlanes; i++)
+		m_uploadedRows[row][i] = words[i];
+
+	packRow(board, row, m_instances + row * Board::kWidth);
+	return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include "Game/Board.h"
+#include "TextureAtlas.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+
+class Shader;
+class DrawList;
+class Texture;
+
+// Submits the visible playfield as one instanced unit quad per cell. The instance buffer is
+// only rewritten for rows whose bitmasks changed since the previous frame.
+class BoardRenderer
+{
+public:
+	static constexpr int kCellCount = Board::kWidth * Board::kVisibleHeight;
+	static constexpr int kColorCount = 1 << Board::kColorPlanes;
+
+	// Palette indexed by board color, 0 being an empty cell
+	static const float kPalette[kColorCount][4];
+
+	// Every cell is the skin region of the atlas tinted by its palette color
+	BoardRenderer(Shader& shader, DrawList& drawList, const Texture& atlas, const AtlasRegion& skin);
+
+	void draw(const Board& board, float left, float top, float cellWidth, float cellHeight);
+
+	// Forces every row to be uploaded on the next draw
+	inline void invalidate() { m_valid = false; }
+	inline unsigned int getBytesUploaded() const { return m_bytesUploaded; }
+
+	// Packs one visible row's cells as x | row << 8 | color << 16, matching Cell.shader
+	static inline void packRow(const Board& board, int row, uint32_t* instances)
+	{
+		const int y = row + Board::kHiddenRows;
+		for (int x = 0; x < Board::kWidth; x++)
+			instances[x] = (uint32_t)x | (uint32_t)row << 8 | (uint32_t)board.getCellColor(x, y) << 16;
+	}
+
+private:
+	bool updateRow(const Board& board, int row);
+
+private:
+	Shader& m_shader;
+	DrawList& m_drawList;
+	const Texture& m_atlas;
+	AtlasRegion m_skin;
+	unsigned int m_shaderGeneration;
+	VertexArray m_vertexArray;
+	VertexBuffer m_quadBuffer;
+	VertexBuffer m_instanceBuffer;
+	IndexBuffer m_indexBuffer;
+
+	// One packed cell per instance, see packRow
+	uint32_t m_instances[kCellCount];
+	// Occupancy and color plane words last written for each visible row
+	uint16_t m_uploadedRows[Board::kVisibleHeight][1 + Board::kColorPlanes];
+	bool m_valid;
+	unsigned int m_bytesUploaded;
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in uint cell;
+
+layout(std140) uniform Frame
+{
+   mat4 u_Projection;
+   vec4 u_Time;
+};
+
+// Left, top, cell width and cell height of the visible field
+uniform vec4 u_Grid;
+uniform vec4 u_Palette[8];
+// Atlas rectangle of the block skin as u0, v0, u1, v1
+uniform vec4 u_SkinRect;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+void main()
+{
+   vec2 coord = vec2(float(cell & 0xFFu), float((cell >> 8) & 0xFFu));
+   vec2 local = 0.05 + position * 0.9;
+   gl_Position = u_Projection * vec4(u_Grid.x + (coord.x + local.x) * u_Grid.z, u_Grid.y - (coord.y + 1.0 - local.y) * u_Grid.w, 0.0, 1.0);
+   v_Color = u_Palette[(cell >> 16) & 0xFFu];
+   v_TexCoord = vec2(mix(u_SkinRect.x, u_SkinRect.z, position.x), mix(u_SkinRect.w, u_SkinRect.y, position.y));
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Atlas;
+
+void main()
+{
+   color = v_Color * texture(u_Atlas, v_TexCoord);
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "DrawList.h"
+#include "RenderState.h"
+#include "GL/glew.h"
+#include <algorithm>
+
+void DrawList::submit(RenderLayer layer, unsigned int program, unsigned int vertexArray, unsigned int texture,
+	unsigned int indexCount, int baseVertex, unsigned int instanceCount)
+{
+	if (m_count == kMaxCommands)
+		execute();
+
+	// Layer, program, vertex array, texture, then submission order so equal state keeps its sequence
+	DrawCommand& command = m_commands[m_count++];
+	command.key = (uint64_t)layer << 56
+		| (uint64_t)(program & 0xFFFF) << 40
+		| (uint64_t)(vertexArray & 0xFFFF) << 24
+		| (uint64_t)(texture & 0xFFFF) << 8
+		| (uint64_t)(m_sequence++ & 0xFF);
+	command.program = program;
+	command.vertexArray = vertexArray;
+	command.texture = texture;
+	command.indexCount = indexCount;
+	command.baseVertex = baseVertex;
+	command.instanceCount = instanceCount;
+}
+
+void DrawList::execute()
+{
+	executeThrough(RenderLayer::Overlay);
+}
+
+void DrawList::executeThrough(RenderLayer last)
+{
+	std::sort(m_commands, m_commands + m_count, [](const DrawCommand& a, const DrawCommand& b) { return a.key < b.key; });
+
+	// The layer is the top byte of the key, so the layers up to last are a prefix of the sorted list
+	const uint64_t limit = ((uint64_t)last + 1) << 56;
+	unsigned int issued = 0;
+	for (; issued < m_count && m_commands[issued].key < limit; issued++)
+	{
+		const DrawCommand& command = m_commands[issued];
+		RenderState::useProgram(command.program);
+		RenderState::bindVertexArray(command.vertexArray);
+		if (command.texture != 0)
+			RenderState::bindTexture(0, GL_TEXTURE_2D, command.texture);
+
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.indexCount, GL_UNSIGNED_INT, nullptr,
+			command.instanceCount, command.baseVertex);
+	}
+
+	std::copy(m_commands + issued, m_commands + m_count, m_commands);
+	m_count -= issued;
+	if (m_count == 0)
+		m_sequence = 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+// Draws are ordered by layer first; within a layer their order does not matter, so they are
+// grouped by program, then vertex array, then texture to keep state changes to a minimum.
+enum class RenderLayer : uint8_t
+{
+	Board, Pieces, Effects, Hud, Overlay
+};
+
+struct DrawCommand
+{
+	uint64_t key;
+	unsigned int program;
+	unsigned int vertexArray;
+	unsigned int texture;
+	unsigned int indexCount;
+	int baseVertex;
+	unsigned int instanceCount;
+};
+
+// Collects a frame's draws into a fixed array and issues them sorted by state in execute
+class DrawList
+{
+public:
+	static constexpr unsigned int kMaxCommands = 256;
+
+	DrawList() : m_count(0), m_sequence(0) {}
+
+	void submit(RenderLayer layer, unsigned int program, unsigned int vertexArray, unsigned int texture,
+		unsigned int indexCount, int baseVertex = 0, unsigned int instanceCount = 1);
+	void execute();
+	// Issues only the draws in layers up to and including last, leaving later layers queued
+	void executeThrough(RenderLayer last);
+
+	inline unsigned int getCount() const { return m_count; }
+
+private:
+	DrawCommand m_commands[kMaxCommands];
+	unsigned int m_count;
+	unsigned int m_sequence;
+};
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "Font.h"
+#include "Core/MappedFile.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <cmath>
+
+namespace
+{
+	const char* kFontCacheDirectory = "cache/fonts";
+	const char* kFontCachePath = "cache/fonts/hud.sdf";
+	const uint32_t kFontCacheMagic = 0x31465354; // "TSF1"
+
+	struct FontCacheHeader
+	{
+		uint32_t magic;
+		uint32_t glyphCount;
+		uint64_t key;
+	};
+
+	const char kGlyphChars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ:.-/%?";
+
+	// One byte per row, top row first, with the leftmost pixel in bit 4
+	const uint8_t kGlyphBitmaps[][Font::kGlyphRows] =
+	{
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+		{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // '0'
+		{ 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // '1'
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // '2'
+		{ 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // '3'
+		{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // '4'
+		{ 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // '5'
+		{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // '6'
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // '7'
+		{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // '8'
+		{ 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // '9'
+		{ 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // 'A'
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // 'B'
+		{ 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // 'C'
+		{ 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // 'D'
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // 'E'
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // 'F'
+		{ 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // 'G'
+		{ 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // 'H'
+		{ 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 'I'
+		{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // 'J'
+		{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // 'K'
+		{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // 'L'
+		{ 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // 'M'
+		{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // 'N'
+		{ 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // 'O'
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // 'P'
+		{ 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // 'Q'
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // 'R'
+		{ 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // 'S'
+		{ 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // 'T'
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // 'U'
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // 'V'
+		{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // 'W'
+		{ 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // 'X'
+		{ 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, // 'Y'
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // 'Z'
+		{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // ':'
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // '.'
+		{ 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // '-'
+		{ 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // '/'
+		{ 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // '%'
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // '?'
+	};
+
+	const float kInfinity = 1e20f;
+
+	// Squared distance transform of one row or column (Felzenszwalb and Huttenlocher). f holds
+	// zero on feature texels and infinity elsewhere; d receives the squared distance to the nearest feature.
+	void distanceTransform1D(const float* f, int n, float* d)
+	{
+		int v[Font::kFieldHeight > Font::kFieldWidth ? Font::kFieldHeight : Font::kFieldWidth];
+		float z[(Font::kFieldHeight > Font::kFieldWidth ? Font::kFieldHeight : Font::kFieldWidth) + 1];
+
+		int k = 0;
+		v[0] = 0;
+		z[0] = -kInfinity;
+		z[1] = kInfinity;
+		for (int q = 1; q < n; q++)
+		{
+			float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+			while (s <= z[k])
+			{
+				k--;
+				s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+			}
+			k++;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = kInfinity;
+		}
+
+		k = 0;
+		for (int q = 0; q < n; q++)
+		{
+			while (z[k + 1] < q)
+				k++;
+			d[q] = (float)(q - v[k]) * (q - v[k]) + f[v[k]];
+		}
+	}
+
+	// Squared distance from every texel to the nearest texel whose inside flag equals target
+	void distanceTransform2D(const bool* inside, bool target, float* distances)
+	{
+		const int width = Font::kFieldWidth;
+		const int height = Font::kFieldHeight;
+		float f[width > height ? width : height];
+		float d[width > height ? width : height];
+
+		for (int x = 0; x < width; x++)
+		{
+			for (int y = 0; y < height; y++)
+				f[y] = inside[y * width + x] == target ? 0.0f : kInfinity;
+			distanceTransform1D(f, height, d);
+			for (int y = 0; y < height; y++)
+				distances[y * width + x] = d[y];
+		}
+
+		for (int y = 0; y < height; y++)
+		{
+			distanceTransform1D(distances + y * width, width, d);
+			memcpy(distances + y * width, d, width * sizeof(float));
+		}
+	}
+
+	// Bakes one glyph into a field with the outline at 128, inside above it and outside below
+	void bakeGlyph(const uint8_t* bitmap, uint8_t* field)
+	{
+		const int width = Font::kFieldWidth;
+		const int height = Font::kFieldHeight;
+		bool inside[width * height];
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const int column = (x - Font::kSpread) / Font::kScale;
+				const int row = (y - Font::kSpread) / Font::kScale;
+				const bool inBitmap = x >= Font::kSpread && y >= Font::kSpread && column < Font::kGlyphColumns && row < Font::kGlyphRows;
+				inside[y * width + x] = inBitmap && ((bitmap[row] >> (Font::kGlyphColumns - 1 - column)) & 1);
+			}
+		}
+
+		float toOutside[width * height];
+		float toInside[width * height];
+		distanceTransform2D(inside, false, toOutside);
+		distanceTransform2D(inside, true, toInside);
+
+		for (int i = 0; i < width * height; i++)
+		{
+			// Texel centres sit half a texel either side of the outline
+			const float distance = inside[i] ? sqrtf(toOutside[i]) - 0.5f : 0.5f - sqrtf(toInside[i]);
+			float value = 0.5f + distance / (2.0f * Font::kSpread);
+			value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+			field[i] = (uint8_t)(value * 255.0f + 0.5f);
+		}
+	}
+
+	uint64_t HashBytes(const void* data, size_t length, uint64_t hash = 14695981039346656037ull)
+	{
+		for (size_t i = 0; i < length; i++)
+			hash = (hash ^ ((const uint8_t*)data)[i]) * 1099511628211ull;
+		return hash;
+	}
+
+	// Baked fields are only valid for the same bitmaps baked with the same parameters
+	uint64_t getFieldsKey()
+	{
+		const int parameters[] = { Font::kScale, Font::kSpread, Font::kFieldWidth, Font::kFieldHeight };
+		return HashBytes(parameters, sizeof(parameters), HashBytes(kGlyphBitmaps, sizeof(kGlyphBitmaps)));
+	}
+}
+
+Font::Font(TextureAtlas& atlas)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	uint8_t* fields = new uint8_t[kFieldBytes];
+	const bool cached = bakeFields(fields);
+	addGlyphs(atlas, fields);
+	delete[] fields;
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Loaded font " << (cached ? "from cache" : "by baking distance fields") << " in " << elapsed.count() << " ms" << std::endl;
+}
+
+Font::Font(TextureAtlas& atlas, const uint8_t* fields)
+{
+	addGlyphs(atlas, fields);
+}
+
+bool Font::bakeFields(uint8_t* fields)
+{
+	static_assert(sizeof(kGlyphBitmaps) / sizeof(kGlyphBitmaps[0]) == kGlyphCount, "Every glyph needs a bitmap");
+
+	if (loadCache(kFontCachePath, fields))
+		return true;
+
+	const int fieldSize = kFieldWidth * kFieldHeight;
+	for (int i = 0; i < kGlyphCount; i++)
+		bakeGlyph(kGlyphBitmaps[i], fields + i * fieldSize);
+	saveCache(kFontCachePath, fields);
+	return false;
+}
+
+void Font::packFields(const uint8_t* fields, uint8_t* packed)
+{
+	static_assert(sizeof(FontCacheHeader) + kFieldBytes == kPackedBytes, "Packed size must match the header");
+
+	const FontCacheHeader header = { kFontCacheMagic, kGlyphCount, getFieldsKey() };
+	memcpy(packed, &header, sizeof(header));
+	memcpy(packed + sizeof(header), fields, kFieldBytes);
+}
+
+const uint8_t* Font::findPackedFields(const uint8_t* packed, size_t size)
+{
+	if (size < (size_t)kPackedBytes)
+		return nullptr;
+
+	FontCacheHeader header;
+	memcpy(&header, packed, sizeof(header));
+	if (header.magic != kFontCacheMagic || header.key != getFieldsKey() || header.glyphCount != kGlyphCount)
+		return nullptr;
+	return packed + sizeof(header);
+}
+
+void Font::addGlyphs(TextureAtlas& atlas, const uint8_t* fields)
+{
+	static_assert(sizeof(kGlyphChars) - 1 == kGlyphCount, "Every glyph needs a character");
+
+	// The field goes in alpha so that the glyphs can sit in the same RGBA atlas as everything else
+	const int fieldSize = kFieldWidth * kFieldHeight;
+	uint8_t* pixels = new uint8_t[fieldSize * 4];
+	for (int i = 0; i < kGlyphCount; i++)
+	{
+		for (int p = 0; p < fieldSize; p++)
+		{
+			pixels[p * 4 + 0] = pixels[p * 4 + 1] = pixels[p * 4 + 2] = 255;
+			pixels[p * 4 + 3] = fields[i * fieldSize + p];
+		}
+
+		if (!atlas.add(kFieldWidth, kFieldHeight, pixels, m_glyphs[i]))
+		{
+			std::cerr << "Texture atlas has no room for glyph '" << kGlyphChars[i] << "'" << std::endl;
+			m_glyphs[i] = m_glyphs[0];
+		}
+	}
+	delete[] pixels;
+
+	const char* missing = strchr(kGlyphChars, '?');
+	for (int c = 0; c < 128; c++)
+	{
+		const char upper = (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : (char)c;
+		const char* found = upper != '\0' ? strchr(kGlyphChars, upper) : nullptr;
+		m_lookup[c] = (uint8_t)((found ? found : missing) - kGlyphChars);
+	}
+}
+
+bool Font::loadCache(const char* cachePath, uint8_t* fields)
+{
+	const MappedFile file(cachePath);
+	const uint8_t* cached = findPackedFields(file.getData(), file.getSize());
+	if (!cached)
+		return false;
+
+	memcpy(fields, cached, kFieldBytes);
+	return true;
+}
+
+void Font::saveCache(const char* cachePath, const uint8_t* fields)
+{
+	std::error_code error;
+	std::filesystem::create_directories(kFontCacheDirectory, error);
+
+	std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return;
+
+	uint8_t* packed = new uint8_t[kPackedBytes];
+	packFields(fields, packed);
+	file.write((const char*)packed, kPackedBytes);
+	delete[] packed;
+}
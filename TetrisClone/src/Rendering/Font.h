@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "TextureAtlas.h"
+
+// Monospaced HUD font kept as signed distance fields in a texture atlas. The glyphs come from a
+// built in 5x7 bitmap set, converted to distance fields the first time and read back from a
+// cache file after that, so they stay sharp at any size the HUD draws them.
+class Font
+{
+public:
+	static constexpr int kGlyphColumns = 5;
+	static constexpr int kGlyphRows = 7;
+	// Field texels per bitmap pixel, and how many texels past the outline distances reach
+	static constexpr int kScale = 6;
+	static constexpr int kSpread = 4;
+	static constexpr int kFieldWidth = kGlyphColumns * kScale + 2 * kSpread;
+	static constexpr int kFieldHeight = kGlyphRows * kScale + 2 * kSpread;
+
+	static constexpr int kGlyphCount = 43;
+	static constexpr int kFieldBytes = kGlyphCount * kFieldWidth * kFieldHeight;
+	// Fields as written to the cache file and packed archives, behind a header identifying the glyph set
+	static constexpr int kPackedBytes = 16 + kFieldBytes;
+	static constexpr const char* kArchiveName = "fonts/hud.sdf";
+
+	// Bakes the fields and adds them to the atlas in one go
+	explicit Font(TextureAtlas& atlas);
+	// Adds fields produced by bakeFields to the atlas
+	Font(TextureAtlas& atlas, const uint8_t* fields);
+
+	// Fills kFieldBytes of fields with every glyph, read from the cache file when it matches and baked
+	// and written back to it otherwise. Touches no GL state, so it can run on any thread. Returns
+	// true if the cache was used.
+	static bool bakeFields(uint8_t* fields);
+
+	// Writes kPackedBytes of header and fields to packed
+	static void packFields(const uint8_t* fields, uint8_t* packed);
+	// Returns where the fields start in packed data, or nullptr if it was made for a different glyph set
+	static const uint8_t* findPackedFields(const uint8_t* packed, size_t size);
+
+	// Lower case letters use their upper case glyph, and anything else missing shows as '?'
+	inline const AtlasRegion& getGlyph(char c) const { return m_glyphs[m_lookup[(uint8_t)c & 0x7F]]; }
+
+	// Margin around the outline included in every glyph region, as a fraction of the glyph's size
+	static constexpr float kMarginX = (float)kSpread / (kGlyphColumns * kScale);
+	static constexpr float kMarginY = (float)kSpread / (kGlyphRows * kScale);
+
+private:
+	void addGlyphs(TextureAtlas& atlas, const uint8_t* fields);
+
+	static bool loadCache(const char* cachePath, uint8_t* fields);
+	static void saveCache(const char* cachePath, const uint8_t* fields);
+
+private:
+	AtlasRegion m_glyphs[kGlyphCount];
+	uint8_t m_lookup[128];
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "FrameCapture.h"
+#include "RenderState.h"
+#include "GL/glew.h"
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <filesystem>
+
+FrameCapture::FrameCapture(int width, int height, const char* outputDirectory)
+	: m_next(0), m_width(width), m_height(height), m_outputDirectory(outputDirectory), m_writtenCount(0)
+{
+	std::error_code error;
+	std::filesystem::create_directories(m_outputDirectory, error);
+
+	for (Slot& slot : m_slots)
+	{
+		glGenBuffers(1, &slot.buffer);
+		RenderState::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, m_width * m_height * 4, nullptr, GL_STREAM_READ);
+		slot.fence = nullptr;
+		slot.frame = 0;
+	}
+	RenderState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+FrameCapture::~FrameCapture()
+{
+	for (Slot& slot : m_slots)
+	{
+		if (slot.fence)
+			glDeleteSync((GLsync)slot.fence);
+		RenderState::onBufferDeleted(slot.buffer);
+		glDeleteBuffers(1, &slot.buffer);
+	}
+}
+
+void FrameCapture::capture(uint64_t frame)
+{
+	// Only blocks when every buffer is still in flight, which means the GPU is several frames behind
+	Slot& slot = m_slots[m_next];
+	if (slot.fence)
+		finish(slot, true);
+
+	RenderState::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	RenderState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.frame = frame;
+	m_next = (m_next + 1) % kBufferCount;
+}
+
+void FrameCapture::collect(bool wait)
+{
+	// Oldest first, stopping at the first one not ready so files are written in frame order
+	for (int i = 0; i < kBufferCount; i++)
+	{
+		Slot& slot = m_slots[(m_next + i) % kBufferCount];
+		if (slot.fence && !finish(slot, wait))
+			break;
+	}
+}
+
+bool FrameCapture::finish(Slot& slot, bool wait)
+{
+	const GLuint64 timeout = wait ? 1000000000ull : 0;
+	const GLenum result = glClientWaitSync((GLsync)slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+	if (result == GL_TIMEOUT_EXPIRED)
+		return false;
+
+	glDeleteSync((GLsync)slot.fence);
+	slot.fence = nullptr;
+
+	RenderState::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	const uint8_t* pixels = (const uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_width * m_height * 4, GL_MAP_READ_BIT);
+	if (pixels)
+	{
+		writeImage(pixels, slot.frame);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	RenderState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	return true;
+}
+
+void FrameCapture::writeImage(const uint8_t* pixels, uint64_t frame)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "frame_%06llu.ppm", (unsigned long long)frame);
+	std::ofstream file(m_outputDirectory + "/" + name, std::ios::binary);
+	if (!file)
+		return;
+
+	// Binary PPM, flipped because GL rows start at the bottom
+	file << "P6\n" << m_width << " " << m_height << "\n255\n";
+	std::vector<uint8_t> row(m_width * 3);
+	for (int y = m_height - 1; y >= 0; y--)
+	{
+		const uint8_t* source = pixels + (size_t)y * m_width * 4;
+		for (int x = 0; x < m_width; x++)
+		{
+			row[x * 3 + 0] = source[x * 4 + 0];
+			row[x * 3 + 1] = source[x * 4 + 1];
+			row[x * 3 + 2] = source[x * 4 + 2];
+		}
+		file.write((const char*)row.data(), row.size());
+	}
+	m_writtenCount++;
+}
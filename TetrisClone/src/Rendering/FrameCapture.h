@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Reads rendered frames back through a ring of pixel pack buffers. A capture only queues the
+// copy; its pixels are written out a few frames later once the GPU has finished with it.
+class FrameCapture
+{
+public:
+	static constexpr int kBufferCount = 3;
+
+	FrameCapture(int width, int height, const char* outputDirectory);
+	~FrameCapture();
+
+	// Queues a readback of the bound read framebuffer, tagged with the frame number used in the file name
+	void capture(uint64_t frame);
+	// Writes out every readback that has completed, or waits for all of them when finishing up
+	void collect(bool wait = false);
+
+	inline unsigned int getWrittenCount() const { return m_writtenCount; }
+
+private:
+	struct Slot
+	{
+		unsigned int buffer;
+		void* fence;
+		uint64_t frame;
+	};
+
+	bool finish(Slot& slot, bool wait);
+	void writeImage(const uint8_t* pixels, uint64_t frame);
+
+private:
+	Slot m_slots[kBufferCount];
+	int m_next;
+	int m_width;
+	int m_height;
+	std::string m_outputDirectory;
+	unsigned int m_writtenCount;
+};
\ No newline at end of file
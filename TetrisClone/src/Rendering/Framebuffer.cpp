@@ -0,0 +1,100 @@
+#include "Framebuffer.h"
+#include "RenderState.h"
+#include "GL/glew.h"
+#include <iostream>
+
+Framebuffer::Framebuffer(int width, int height)
+	: m_rendererID(0), m_colorAttachment(0), m_width(width), m_height(height)
+{
+	create();
+}
+
+Framebuffer::Framebuffer(Framebuffer&& other) noexcept
+	: m_rendererID(other.m_rendererID), m_colorAttachment(other.m_colorAttachment), m_width(other.m_width), m_height(other.m_height)
+{
+	other.m_rendererID = 0;
+	other.m_colorAttachment = 0;
+}
+
+Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		destroy();
+		m_rendererID = other.m_rendererID;
+		m_colorAttachment = other.m_colorAttachment;
+		m_width = other.m_width;
+		m_height = other.m_height;
+		other.m_rendererID = 0;
+		other.m_colorAttachment = 0;
+	}
+	return *this;
+}
+
+Framebuffer::~Framebuffer()
+{
+	destroy();
+}
+
+void Framebuffer::resize(int width, int height)
+{
+	if (width == m_width && height == m_height)
+		return;
+
+	m_width = width;
+	m_height = height;
+	destroy();
+	create();
+}
+
+void Framebuffer::bind() const
+{
+	RenderState::bindFramebuffer(m_rendererID);
+	glViewport(0, 0, m_width, m_height);
+}
+
+void Framebuffer::unbind() const
+{
+	RenderState::bindFramebuffer(0);
+}
+
+void Framebuffer::blitTo(unsigned int framebuffer, int width, int height) const
+{
+	// Only the read binding changes behind the state tracker's back, and it is put back before returning
+	RenderState::bindFramebuffer(framebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_rendererID);
+	glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+}
+
+void Framebuffer::create()
+{
+	glGenTextures(1, &m_colorAttachment);
+	RenderState::bindTexture(0, GL_TEXTURE_2D, m_colorAttachment);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	RenderState::bindTexture(0, GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &m_rendererID);
+	RenderState::bindFramebuffer(m_rendererID);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorAttachment, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cerr << "Framebuffer " << m_width << "x" << m_height << " is incomplete" << std::endl;
+	RenderState::bindFramebuffer(0);
+}
+
+void Framebuffer::destroy()
+{
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onFramebufferDeleted(m_rendererID);
+	RenderState::onTextureDeleted(m_colorAttachment);
+	glDeleteFramebuffers(1, &m_rendererID);
+	glDeleteTextures(1, &m_colorAttachment);
+	m_rendererID = 0;
+	m_colorAttachment = 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// Offscreen render target with a single RGBA8 color texture
+class Framebuffer
+{
+public:
+	// An empty framebuffer owns nothing until one is moved into it
+	Framebuffer() : m_rendererID(0), m_colorAttachment(0), m_width(0), m_height(0) {}
+	Framebuffer(int width, int height);
+	~Framebuffer();
+	// Owns its GL object, so it can be moved but never copied
+	Framebuffer(const Framebuffer&) = delete;
+	Framebuffer& operator=(const Framebuffer&) = delete;
+	Framebuffer(Framebuffer&& other) noexcept;
+	Framebuffer& operator=(Framebuffer&& other) noexcept;
+
+	// Reallocates the attachment, doing nothing if the size is unchanged
+	void resize(int width, int height);
+
+	// Binds for drawing and sets the viewport to cover the whole target
+	void bind() const;
+	void unbind() const;
+	// Scales the color attachment over the whole of another framebuffer, 0 being the window's,
+	// and leaves that one bound
+	void blitTo(unsigned int framebuffer, int width, int height) const;
+
+	inline int getWidth() const { return m_width; }
+	inline int getHeight() const { return m_height; }
+	inline unsigned int getRendererID() const { return m_rendererID; }
+	inline unsigned int getColorAttachment() const { return m_colorAttachment; }
+	inline bool isValid() const { return m_rendererID != 0; }
+
+private:
+	void create();
+	void destroy();
+
+private:
+	unsigned int m_rendererID;
+	unsigned int m_colorAttachment;
+	int m_width;
+	int m_height;
+};
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "GpuTimer.h"
+#include "Core/Profiler.h"
+#include "GL/glew.h"
+
+GpuTimer::GpuTimer() : m_slot(0), m_lastFrameMs(0.0)
+{
+	for (int i = 0; i < kSlotCount; i++)
+	{
+		glGenQueries(2, m_queries[i]);
+		m_issued[i] = false;
+	}
+
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	m_clockOffset = (int64_t)Profiler::now() - (int64_t)gpuNow;
+}
+
+GpuTimer::GpuTimer(GpuTimer&& other) noexcept
+	: m_slot(other.m_slot), m_clockOffset(other.m_clockOffset), m_lastFrameMs(other.m_lastFrameMs)
+{
+	for (int i = 0; i < kSlotCount; i++)
+	{
+		m_queries[i][0] = other.m_queries[i][0];
+		m_queries[i][1] = other.m_queries[i][1];
+		m_issued[i] = other.m_issued[i];
+		other.m_queries[i][0] = other.m_queries[i][1] = 0;
+		other.m_issued[i] = false;
+	}
+}
+
+GpuTimer& GpuTimer::operator=(GpuTimer&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_slot = other.m_slot;
+		m_clockOffset = other.m_clockOffset;
+		m_lastFrameMs = other.m_lastFrameMs;
+		for (int i = 0; i < kSlotCount; i++)
+		{
+			m_queries[i][0] = other.m_queries[i][0];
+			m_queries[i][1] = other.m_queries[i][1];
+			m_issued[i] = other.m_issued[i];
+			other.m_queries[i][0] = other.m_queries[i][1] = 0;
+			other.m_issued[i] = false;
+		}
+	}
+	return *this;
+}
+
+GpuTimer::~GpuTimer()
+{
+	release();
+}
+
+void GpuTimer::release()
+{
+	// Deleting query name zero is silently ignored, so a moved from timer needs no check
+	for (int i = 0; i < kSlotCount; i++)
+	{
+		glDeleteQueries(2, m_queries[i]);
+		m_queries[i][0] = m_queries[i][1] = 0;
+		m_issued[i] = false;
+	}
+}
+
+void GpuTimer::beginFrame()
+{
+	collect(m_slot);
+	glQueryCounter(m_queries[m_slot][0], GL_TIMESTAMP);
+}
+
+void GpuTimer::endFrame()
+{
+	glQueryCounter(m_queries[m_slot][1], GL_TIMESTAMP);
+	m_issued[m_slot] = true;
+	m_slot = (m_slot + 1) % kSlotCount;
+}
+
+void GpuTimer::collect(int slot)
+{
+	if (!m_issued[slot])
+		return;
+	m_issued[slot] = false;
+
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(m_queries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == GL_FALSE)
+		return;
+
+	GLuint64 start = 0;
+	GLuint64 end = 0;
+	glGetQueryObjectui64v(m_queries[slot][0], GL_QUERY_RESULT, &start);
+	glGetQueryObjectui64v(m_queries[slot][1], GL_QUERY_RESULT, &end);
+
+	m_lastFrameMs = (end - start) / 1000000.0;
+	Profiler::recordGpuScope("GPU Frame", (uint64_t)((int64_t)start + m_clockOffset), (uint64_t)((int64_t)end + m_clockOffset));
+}
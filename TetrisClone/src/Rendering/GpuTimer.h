@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+// Measures GPU frame time with GL_TIMESTAMP queries at the start and end of each frame. Queries
+// alternate between two slots and a result is only read once the driver reports it available,
+// so measuring never stalls the pipeline; a frame whose result is late is simply skipped.
+class GpuTimer
+{
+public:
+	static constexpr int kSlotCount = 2;
+
+	GpuTimer();
+	~GpuTimer();
+	// Owns its GL object, so it can be moved but never copied
+	GpuTimer(const GpuTimer&) = delete;
+	GpuTimer& operator=(const GpuTimer&) = delete;
+	GpuTimer(GpuTimer&& other) noexcept;
+	GpuTimer& operator=(GpuTimer&& other) noexcept;
+
+	void beginFrame();
+	void endFrame();
+
+	inline double getLastFrameMs() const { return m_lastFrameMs; }
+
+private:
+	void collect(int slot);
+	void release();
+
+private:
+	unsigned int m_queries[kSlotCount][2];
+	bool m_issued[kSlotCount];
+	int m_slot;
+	// Added to GPU timestamps to put them on the profiler's clock
+	int64_t m_clockOffset;
+	double m_lastFrameMs;
+};
\ No newline at end of file
@@ -1,26 +1,56 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
+#include "RenderState.h"
 #include "GL/glew.h"
 #include "GLFW/glfw3.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count) : m_count(count)
 {
 	glGenBuffers(1, &m_rendererID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
+	RenderState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW);
 }
 
+IndexBuffer::IndexBuffer(IndexBuffer&& other) noexcept : m_rendererID(other.m_rendererID), m_count(other.m_count)
+{
+	other.m_rendererID = 0;
+	other.m_count = 0;
+}
+
+IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_rendererID = other.m_rendererID;
+		m_count = other.m_count;
+		other.m_rendererID = 0;
+		other.m_count = 0;
+	}
+	return *this;
+}
+
 IndexBuffer::~IndexBuffer()
 {
+	release();
+}
+
+void IndexBuffer::release()
+{
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onBufferDeleted(m_rendererID);
 	glDeleteBuffers(1, &m_rendererID);
+	m_rendererID = 0;
 }
 
 void IndexBuffer::bind() const
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
+	RenderState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
 }
 
 void IndexBuffer::unbind() const
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	RenderState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
@@ -6,12 +6,20 @@ public:
 	IndexBuffer() : m_rendererID(0), m_count(0) {}
 	IndexBuffer(const unsigned int* data, unsigned int count);
 	~IndexBuffer();
+	// Owns its GL object, so it can be moved but never copied
+	IndexBuffer(const IndexBuffer&) = delete;
+	IndexBuffer& operator=(const IndexBuffer&) = delete;
+	IndexBuffer(IndexBuffer&& other) noexcept;
+	IndexBuffer& operator=(IndexBuffer&& other) noexcept;
 
 	void bind() const;
 	void unbind() const;
 
 	inline unsigned int getCount() const { return m_count; }
 
+private:
+	void release();
+
 private:
 	unsigned int m_rendererID;
 	unsigned int m_count;
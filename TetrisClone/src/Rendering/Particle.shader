@@ -0,0 +1,61 @@
+#shader vertex
+#version 430 core
+
+layout(std140) uniform Frame
+{
+   mat4 u_Projection;
+   vec4 u_Time;
+};
+
+struct Particle
+{
+   vec2 position;
+   vec2 velocity;
+   vec4 color;
+   // Age, lifetime, size and one unused float
+   vec4 life;
+};
+
+layout(std430, binding = 0) readonly buffer Particles
+{
+   Particle particles[];
+};
+
+// Height over width of the target, keeping particles round
+uniform float u_Aspect;
+
+out vec4 v_Color;
+out vec2 v_Offset;
+
+void main()
+{
+   Particle p = particles[gl_InstanceID];
+
+   // Corner of the quad from the index buffer's 0, 1, 2, 3 winding, from -1 to 1
+   v_Offset = vec2(float(((gl_VertexID + 1) >> 1) & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+   if (p.life.x >= p.life.y)
+   {
+      // Dead particles collapse to one point outside the clip volume and rasterize nothing
+      v_Color = vec4(0.0);
+      gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+      return;
+   }
+
+   float fade = 1.0 - p.life.x / p.life.y;
+   vec2 size = vec2(p.life.z * u_Aspect, p.life.z) * (0.5 + 0.5 * fade);
+   v_Color = vec4(p.color.rgb, p.color.a * fade);
+   gl_Position = u_Projection * vec4(p.position + v_Offset * size, 0.0, 1.0);
+};
+
+#shader fragment
+#version 430 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_Offset;
+
+void main()
+{
+   color = vec4(v_Color.rgb, v_Color.a * (1.0 - smoothstep(0.4, 1.0, length(v_Offset))));
+};
\ No newline at end of file
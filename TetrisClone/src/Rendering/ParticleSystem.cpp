@@ -0,0 +1,100 @@
+#include "ParticleSystem.h"
+#include "Shader.h"
+#include "DrawList.h"
+#include "Core/Profiler.h"
+#include "GL/glew.h"
+#include <cstring>
+#include <cstddef>
+
+namespace
+{
+	constexpr UniformName kAspectUniform("u_Aspect");
+}
+
+ParticleSystem::ParticleSystem(Shader& updateShader, Shader& drawShader, DrawList& drawList)
+	: m_updateShader(updateShader), m_drawShader(drawShader), m_drawList(drawList),
+	m_particles(kMaxParticles * kParticleBytes, kStorageBinding), m_uniformBuffer(sizeof(Uniforms), kBurstBinding),
+	m_burstCount(0), m_head(0), m_slotCount(0), m_seed(0x9E3779B9u), m_remainingSeconds(0.0f)
+{
+	static_assert((kMaxParticles & (kMaxParticles - 1)) == 0, "The update shader wraps slots with a mask");
+	static_assert(kMaxParticles % kWorkGroupSize == 0, "Dispatches cover whole work groups");
+	memset(&m_uniforms, 0, sizeof(m_uniforms));
+
+	m_updateShader.BindUniformBlock("Bursts", kBurstBinding);
+
+	// Corners come from gl_VertexID, so the quad needs indices and no vertex buffer at all
+	unsigned int indices[] =
+	{
+		0, 1, 2,
+		2, 3, 0
+	};
+
+	m_indexBuffer = IndexBuffer(indices, 6);
+	m_vertexArray.setIndexBuffer(m_indexBuffer);
+	m_vertexArray.unbind();
+	m_indexBuffer.unbind();
+}
+
+bool ParticleSystem::emit(float left, float bottom, float width, float height, const float color[4], unsigned int count,
+	float speed, float lifetime, float lift, float size)
+{
+	if (m_burstCount == kMaxBursts || count == 0)
+		return false;
+
+	if (count > kMaxParticles)
+		count = kMaxParticles;
+
+	ParticleBurst& burst = m_uniforms.bursts[m_burstCount++];
+	const float rect[4] = { left, bottom, width, height };
+	const float motion[4] = { speed, lifetime, lift, size };
+	memcpy(burst.rect, rect, sizeof(rect));
+	memcpy(burst.color, color, sizeof(burst.color));
+	memcpy(burst.motion, motion, sizeof(motion));
+	burst.range[0] = m_head;
+	burst.range[1] = count;
+	burst.range[2] = m_seed;
+	burst.range[3] = 0;
+
+	// The oldest particles are the ones overwritten once the ring is full
+	m_seed = m_seed * 1664525u + 1013904223u;
+	m_head = (m_head + count) & (kMaxParticles - 1);
+	m_slotCount = m_slotCount + count < kMaxParticles ? m_slotCount + count : kMaxParticles;
+	if (lifetime > m_remainingSeconds)
+		m_remainingSeconds = lifetime;
+	return true;
+}
+
+void ParticleSystem::update(float deltaSeconds, float aspect)
+{
+	if (!isActive())
+		return;
+
+	PROFILE_SCOPE("Particles");
+	const float step[4] = { deltaSeconds, kGravity, kDamping, aspect };
+	memcpy(m_uniforms.step, step, sizeof(step));
+	m_uniforms.counts[0] = m_burstCount;
+	m_uniforms.counts[1] = kMaxParticles;
+	m_uniforms.counts[2] = m_slotCount;
+	m_uniforms.counts[3] = 0;
+	m_uniformBuffer.setData(&m_uniforms, (unsigned int)(offsetof(Uniforms, bursts) + m_burstCount * sizeof(ParticleBurst)));
+
+	m_updateShader.Dispatch((m_slotCount + kWorkGroupSize - 1) / kWorkGroupSize);
+	// The draw reads what the dispatch just wrote
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	m_burstCount = 0;
+	m_remainingSeconds -= deltaSeconds;
+
+	m_drawShader.Bind();
+	m_drawShader.SetUniform1f(kAspectUniform, aspect);
+	m_drawList.submit(RenderLayer::Effects, m_drawShader.GetRendererID(), m_vertexArray.getRendererID(), 0, 6, 0, m_slotCount);
+}
+
+void ParticleSystem::clear()
+{
+	m_particles.clear();
+	m_burstCount = 0;
+	m_head = 0;
+	m_slotCount = 0;
+	m_remainingSeconds = 0.0f;
+}
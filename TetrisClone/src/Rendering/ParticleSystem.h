@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "StorageBuffer.h"
+#include "UniformBuffer.h"
+
+class Shader;
+class DrawList;
+
+// Particle state for a burst, laid out std140 to match ParticleUpdate.shader
+struct ParticleBurst
+{
+	// Left, bottom, width and height of the area the particles appear in
+	float rect[4];
+	float color[4];
+	// Speed, lifetime in seconds, upward velocity and size
+	float motion[4];
+	// First ring slot, particle count, random seed and one unused word
+	uint32_t range[4];
+};
+
+// Effects whose particles live entirely in GPU memory. Every particle is a slot in a ring held
+// in a storage buffer; emitting only queues a burst naming a run of slots, which the update
+// compute shader fills in on its next step before advancing every live slot. Drawing is one
+// instanced quad per slot read straight from the same buffer, so a frame costs one small
+// uniform upload, one dispatch and one draw however many particles are alive. Needs GL 4.3.
+class ParticleSystem
+{
+public:
+	static constexpr unsigned int kMaxParticles = 1 << 16;
+	// Matches the size of the u_Bursts array in ParticleUpdate.shader
+	static constexpr unsigned int kMaxBursts = 32;
+	// One std430 Particle: position, velocity, color, then age, lifetime and size
+	static constexpr unsigned int kParticleBytes = 48;
+	// Matches local_size_x in ParticleUpdate.shader
+	static constexpr unsigned int kWorkGroupSize = 256;
+	// Matches the binding of the Particles block in both particle shaders
+	static constexpr unsigned int kStorageBinding = 0;
+	static constexpr unsigned int kBurstBinding = 1;
+	// Downward acceleration and the fraction of velocity lost per second, in clip units
+	static constexpr float kGravity = 1.5f;
+	static constexpr float kDamping = 1.0f;
+
+	ParticleSystem(Shader& updateShader, Shader& drawShader, DrawList& drawList);
+
+	// Queues count particles spread over the rectangle, colored around color and thrown outward at
+	// up to speed. They spawn on the next update; bursts past kMaxBursts in one frame are dropped.
+	bool emit(float left, float bottom, float width, float height, const float color[4], unsigned int count,
+		float speed, float lifetime, float lift, float size);
+
+	// Advances every live particle by deltaSeconds and submits the draw. Does nothing once
+	// every particle has expired, until the next emit.
+	void update(float deltaSeconds, float aspect);
+
+	// Starts over with every particle dead
+	void clear();
+
+	inline bool isActive() const { return m_burstCount > 0 || m_remainingSeconds > 0.0f; }
+	// Slots the shaders visit each frame: every slot once the ring has wrapped
+	inline unsigned int getSlotCount() const { return m_slotCount; }
+
+private:
+	// Step parameters ahead of the bursts, so an update only uploads the bursts it uses
+	struct Uniforms
+	{
+		// Seconds to advance, gravity, damping and height over width
+		float step[4];
+		// Bursts this step, slots in the ring, slots in use and one unused word
+		uint32_t counts[4];
+		ParticleBurst bursts[kMaxBursts];
+	};
+
+private:
+	Shader& m_updateShader;
+	Shader& m_drawShader;
+	DrawList& m_drawList;
+	StorageBuffer m_particles;
+	UniformBuffer m_uniformBuffer;
+	VertexArray m_vertexArray;
+	IndexBuffer m_indexBuffer;
+
+	Uniforms m_uniforms;
+	unsigned int m_burstCount;
+	// Next ring slot to emit into, and how many slots have ever been used
+	unsigned int m_head;
+	unsigned int m_slotCount;
+	uint32_t m_seed;
+	// Until every particle emitted so far has certainly expired
+	float m_remainingSeconds;
+};
\ No newline at end of file
@@ -0,0 +1,91 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 256) in;
+
+struct Particle
+{
+   vec2 position;
+   vec2 velocity;
+   vec4 color;
+   // Age, lifetime, size and one unused float
+   vec4 life;
+};
+
+// Slots range.x up to range.x + range.y, wrapping round the ring, are respawned with seed range.z
+struct Burst
+{
+   // Left, bottom, width and height of the area particles appear in
+   vec4 rect;
+   vec4 color;
+   // Speed, lifetime, upward velocity and size
+   vec4 motion;
+   uvec4 range;
+};
+
+layout(std430, binding = 0) buffer Particles
+{
+   Particle particles[];
+};
+
+layout(std140) uniform Bursts
+{
+   // Seconds to advance, downward acceleration, damping per second and height over width
+   vec4 u_Step;
+   // Bursts this step, slots in the ring and slots ever used
+   uvec4 u_Counts;
+   Burst u_Bursts[32];
+};
+
+uint hash(uint x)
+{
+   x ^= x >> 16;
+   x *= 0x7FEB352Du;
+   x ^= x >> 15;
+   x *= 0x846CA68Bu;
+   x ^= x >> 16;
+   return x;
+}
+
+float random(inout uint state)
+{
+   state = hash(state);
+   return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+void spawn(uint index, Burst burst)
+{
+   uint state = index ^ (burst.range.z * 0x9E3779B9u);
+   float angle = random(state) * 6.2831853;
+   float speed = burst.motion.x * (0.25 + 0.75 * random(state));
+
+   Particle p;
+   p.position = burst.rect.xy + vec2(random(state), random(state)) * burst.rect.zw;
+   p.velocity = vec2(cos(angle) * u_Step.w, sin(angle)) * speed + vec2(0.0, burst.motion.z);
+   p.color = vec4(burst.color.rgb * (0.8 + 0.4 * random(state)), burst.color.a);
+   p.life = vec4(0.0, burst.motion.y * (0.5 + 0.5 * random(state)), burst.motion.w * (0.5 + random(state)), 0.0);
+   particles[index] = p;
+}
+
+void main()
+{
+   uint index = gl_GlobalInvocationID.x;
+   if (index >= u_Counts.z)
+      return;
+
+   for (uint i = 0u; i < u_Counts.x; i++)
+   {
+      if (((index - u_Bursts[i].range.x) & (u_Counts.y - 1u)) < u_Bursts[i].range.y)
+         spawn(index, u_Bursts[i]);
+   }
+
+   Particle p = particles[index];
+   if (p.life.x >= p.life.y)
+      return;
+
+   p.velocity.y -= u_Step.y * u_Step.x;
+   p.velocity *= max(1.0 - u_Step.z * u_Step.x, 0.0);
+   p.position += p.velocity * u_Step.x;
+   p.life.x += u_Step.x;
+   particles[index] = p;
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+struct QuadVertex
+{
+	float x, y;
+	float u, v;
+	uint8_t color[4];
+	float texIndex;
+};
+
+// Writes the four corners of an axis aligned quad, counter clockwise from the bottom left to
+// match the shared quad index pattern. Needs no GL, so it can be measured on its own.
+inline void writeQuadVertices(QuadVertex* quad, float x, float y, float width, float height, const uint8_t rgba[4],
+	float u0, float v0, float u1, float v1, float texIndex)
+{
+	const float right = x + width;
+	const float top = y + height;
+	const float corners[4][4] =
+	{
+		{ x, y, u0, v0 },
+		{ right, y, u1, v0 },
+		{ right, top, u1, v1 },
+		{ x, top, u0, v1 }
+	};
+
+	for (int i = 0; i < 4; i++)
+	{
+		quad[i].x = corners[i][0];
+		quad[i].y = corners[i][1];
+		quad[i].u = corners[i][2];
+		quad[i].v = corners[i][3];
+		quad[i].color[0] = rgba[0];
+		quad[i].color[1] = rgba[1];
+		quad[i].color[2] = rgba[2];
+		quad[i].color[3] = rgba[3];
+		quad[i].texIndex = texIndex;
+	}
+}
\ No newline at end of file
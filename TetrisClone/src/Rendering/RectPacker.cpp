@@ -0,0 +1,98 @@
+#include "RectPacker.h"
+
+RectPacker::RectPacker(int width, int height)
+	: m_width(width), m_height(height), m_usedArea(0)
+{
+	clear();
+}
+
+void RectPacker::clear()
+{
+	m_skyline.clear();
+	m_skyline.push_back({ 0, 0, m_width });
+	m_usedArea = 0;
+}
+
+int RectPacker::fit(size_t index, int width, int height) const
+{
+	const int x = m_skyline[index].x;
+	if (x + width > m_width)
+		return -1;
+
+	// Rest on the highest segment the rectangle spans
+	int y = 0;
+	int remaining = width;
+	for (size_t i = index; remaining > 0; i++)
+	{
+		if (m_skyline[i].y > y)
+			y = m_skyline[i].y;
+		if (y + height > m_height)
+			return -1;
+		remaining -= m_skyline[i].width;
+	}
+	return y;
+}
+
+bool RectPacker::pack(int width, int height, int& x, int& y)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	int bestIndex = -1;
+	int bestY = m_height;
+	int bestWidth = m_width + 1;
+	for (size_t i = 0; i < m_skyline.size(); i++)
+	{
+		const int top = fit(i, width, height);
+		if (top < 0)
+			continue;
+
+		if (top < bestY || (top == bestY && m_skyline[i].width < bestWidth))
+		{
+			bestIndex = (int)i;
+			bestY = top;
+			bestWidth = m_skyline[i].width;
+		}
+	}
+
+	if (bestIndex < 0)
+		return false;
+
+	x = m_skyline[bestIndex].x;
+	y = bestY;
+
+	// The new segment covers the rectangle's top; trim or drop the segments it now hides
+	const Segment placed = { x, y + height, width };
+	m_skyline.insert(m_skyline.begin() + bestIndex, placed);
+	const int right = x + width;
+	for (size_t i = bestIndex + 1; i < m_skyline.size();)
+	{
+		Segment& segment = m_skyline[i];
+		if (segment.x >= right)
+			break;
+
+		const int overlap = right - segment.x;
+		if (overlap < segment.width)
+		{
+			segment.x += overlap;
+			segment.width -= overlap;
+			break;
+		}
+		m_skyline.erase(m_skyline.begin() + i);
+	}
+
+	// Merge neighbours left at the same height
+	for (size_t i = 0; i + 1 < m_skyline.size();)
+	{
+		if (m_skyline[i].y == m_skyline[i + 1].y)
+		{
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + i + 1);
+		}
+		else
+			i++;
+	}
+
+	m_usedArea += (long long)width * height;
+	return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Skyline packer: tracks the top edge of everything placed so far as a list of horizontal
+// segments and puts each new rectangle where it ends up lowest, breaking ties by the
+// narrowest segment. Rectangles are never freed individually, only all at once with clear.
+class RectPacker
+{
+public:
+	RectPacker(int width, int height);
+
+	// Finds room for a rectangle and writes its top left corner, returning false if it does not fit
+	bool pack(int width, int height, int& x, int& y);
+	void clear();
+
+	inline int getWidth() const { return m_width; }
+	inline int getHeight() const { return m_height; }
+	// Fraction of the area covered by packed rectangles
+	inline float getOccupancy() const { return (float)m_usedArea / ((float)m_width * m_height); }
+
+private:
+	// Returns the y a rectangle starting at the given segment would rest at, or -1 if it does not fit
+	int fit(size_t index, int width, int height) const;
+
+private:
+	struct Segment
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	int m_width;
+	int m_height;
+	long long m_usedArea;
+	std::vector<Segment> m_skyline;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "RenderState.h"
+#include "GL/glew.h"
+
+RenderState::Counters RenderState::s_counters = { 0, 0 };
+
+namespace
+{
+	// Never a real GL name, so the first bind of anything always goes through
+	const unsigned int kUnknown = 0xFFFFFFFFu;
+
+	enum BufferSlot
+	{
+		ArrayBufferSlot, ElementBufferSlot, UniformBufferSlot, PixelPackBufferSlot, ShaderStorageBufferSlot, BufferSlotCount
+	};
+
+	enum TextureSlot
+	{
+		Texture2DSlot, Texture2DArraySlot, TextureSlotCount
+	};
+
+	unsigned int s_program = kUnknown;
+	unsigned int s_vertexArray = kUnknown;
+	unsigned int s_buffers[BufferSlotCount] = { kUnknown, kUnknown, kUnknown, kUnknown, kUnknown };
+	unsigned int s_framebuffer = kUnknown;
+	unsigned int s_activeUnit = kUnknown;
+
+	struct TextureBindings
+	{
+		unsigned int names[RenderState::kTextureUnits][TextureSlotCount];
+
+		TextureBindings() { clear(); }
+
+		void clear()
+		{
+			for (unsigned int unit = 0; unit < RenderState::kTextureUnits; unit++)
+			{
+				for (int slot = 0; slot < TextureSlotCount; slot++)
+					names[unit][slot] = kUnknown;
+			}
+		}
+	} s_textures;
+
+	int getBufferSlot(unsigned int target)
+	{
+		switch (target)
+		{
+		case GL_ARRAY_BUFFER: return ArrayBufferSlot;
+		case GL_ELEMENT_ARRAY_BUFFER: return ElementBufferSlot;
+		case GL_UNIFORM_BUFFER: return UniformBufferSlot;
+		case GL_PIXEL_PACK_BUFFER: return PixelPackBufferSlot;
+		case GL_SHADER_STORAGE_BUFFER: return ShaderStorageBufferSlot;
+		}
+		return -1;
+	}
+
+	int getTextureSlot(unsigned int target)
+	{
+		switch (target)
+		{
+		case GL_TEXTURE_2D: return Texture2DSlot;
+		case GL_TEXTURE_2D_ARRAY: return Texture2DArraySlot;
+		}
+		return -1;
+	}
+}
+
+bool RenderState::change(unsigned int& cached, unsigned int value)
+{
+	if (cached == value)
+	{
+		s_counters.skipped++;
+		return false;
+	}
+
+	cached = value;
+	s_counters.issued++;
+	return true;
+}
+
+void RenderState::useProgram(unsigned int program)
+{
+	if (change(s_program, program))
+		glUseProgram(program);
+}
+
+void RenderState::bindVertexArray(unsigned int vertexArray)
+{
+	if (!change(s_vertexArray, vertexArray))
+		return;
+
+	// The element buffer binding lives in the vertex array, so it is unknown after switching
+	glBindVertexArray(vertexArray);
+	s_buffers[ElementBufferSlot] = kUnknown;
+}
+
+void RenderState::bindBuffer(unsigned int target, unsigned int buffer)
+{
+	const int slot = getBufferSlot(target);
+	if (slot < 0)
+	{
+		s_counters.issued++;
+		glBindBuffer(target, buffer);
+		return;
+	}
+
+	if (change(s_buffers[slot], buffer))
+		glBindBuffer(target, buffer);
+}
+
+void RenderState::bindFramebuffer(unsigned int framebuffer)
+{
+	if (change(s_framebuffer, framebuffer))
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void RenderState::bindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	const int slot = getTextureSlot(target);
+	if (unit >= kTextureUnits || slot < 0)
+	{
+		s_counters.issued++;
+		s_activeUnit = unit;
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(target, texture);
+		return;
+	}
+
+	if (s_textures.names[unit][slot] == texture)
+	{
+		s_counters.skipped++;
+		return;
+	}
+
+	if (change(s_activeUnit, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+	s_textures.names[unit][slot] = texture;
+	s_counters.issued++;
+	glBindTexture(target, texture);
+}
+
+void RenderState::onProgramDeleted(unsigned int program)
+{
+	if (s_program == program)
+		s_program = kUnknown;
+}
+
+void RenderState::onVertexArrayDeleted(unsigned int vertexArray)
+{
+	// Deleting the bound vertex array reverts the binding to zero
+	if (s_vertexArray == vertexArray)
+	{
+		s_vertexArray = 0;
+		s_buffers[ElementBufferSlot] = kUnknown;
+	}
+}
+
+void RenderState::onBufferDeleted(unsigned int buffer)
+{
+	for (int slot = 0; slot < BufferSlotCount; slot++)
+	{
+		if (s_buffers[slot] == buffer)
+			s_buffers[slot] = 0;
+	}
+}
+
+void RenderState::onFramebufferDeleted(unsigned int framebuffer)
+{
+	if (s_framebuffer == framebuffer)
+		s_framebuffer = 0;
+}
+
+void RenderState::onTextureDeleted(unsigned int texture)
+{
+	for (unsigned int unit = 0; unit < kTextureUnits; unit++)
+	{
+		for (int slot = 0; slot < TextureSlotCount; slot++)
+		{
+			if (s_textures.names[unit][slot] == texture)
+				s_textures.names[unit][slot] = 0;
+		}
+	}
+}
+
+void RenderState::invalidate()
+{
+	s_program = kUnknown;
+	s_vertexArray = kUnknown;
+	for (int slot = 0; slot < BufferSlotCount; slot++)
+		s_buffers[slot] = kUnknown;
+	s_framebuffer = kUnknown;
+	s_activeUnit = kUnknown;
+	s_textures.clear();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Mirror of the GL bindings the renderer touches. Every bind goes through here and is skipped
+// when the object is already bound. Deleting an object must be reported so that a recycled
+// name is not mistaken for the one still cached.
+class RenderState
+{
+public:
+	static constexpr unsigned int kTextureUnits = 16;
+
+	struct Counters
+	{
+		unsigned int issued;
+		unsigned int skipped;
+	};
+
+	static void useProgram(unsigned int program);
+	static void bindVertexArray(unsigned int vertexArray);
+	static void bindBuffer(unsigned int target, unsigned int buffer);
+	static void bindFramebuffer(unsigned int framebuffer);
+	static void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+
+	static void onProgramDeleted(unsigned int program);
+	static void onVertexArrayDeleted(unsigned int vertexArray);
+	static void onBufferDeleted(unsigned int buffer);
+	static void onFramebufferDeleted(unsigned int framebuffer);
+	static void onTextureDeleted(unsigned int texture);
+
+	// Forgets every cached binding, for when GL state was changed behind the tracker's back
+	static void invalidate();
+
+	static inline const Counters& getFrameCounters() { return s_counters; }
+	static inline void resetFrameCounters() { s_counters = { 0, 0 }; }
+
+private:
+	static bool change(unsigned int& cached, unsigned int value);
+
+private:
+	static Counters s_counters;
+};
\ No newline at end of file
@@ -1 +1,127 @@
 #include "Renderer.h"
+#include "VertexBufferLayout.h"
+#include "Shader.h"
+#include "DrawList.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "GL/glew.h"
+
+Renderer::Renderer(DrawList& drawList)
+	: m_vertexBuffer(kMaxVertices * sizeof(QuadVertex), kFramesInFlight), m_drawList(drawList), m_material(nullptr), m_texture(nullptr), m_layer(RenderLayer::Pieces), m_vertices(nullptr), m_vertexCount(0), m_vertexCapacity(0), m_drawCalls(0), m_quadCount(0)
+{
+	VertexBufferLayout layout;
+	layout.push<float>(2);
+	layout.push<float>(2);
+	layout.push<unsigned char>(4);
+	layout.push<float>(1);
+	m_vertexArray.addBuffer(m_vertexBuffer, layout);
+
+	// Every quad uses the same two triangles, offset by four vertices per slot
+	unsigned int* indices = new unsigned int[kMaxIndices];
+	for (unsigned int i = 0; i < kMaxQuads; i++)
+	{
+		const unsigned int base = i * 4;
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 3;
+		indices[i * 6 + 5] = base + 0;
+	}
+	m_indexBuffer = IndexBuffer(indices, kMaxIndices);
+	m_vertexArray.setIndexBuffer(m_indexBuffer);
+	delete[] indices;
+
+	m_vertexArray.unbind();
+	m_vertexBuffer.unbind();
+	m_indexBuffer.unbind();
+}
+
+void Renderer::begin(Shader& material, RenderLayer layer, const Texture* texture)
+{
+	if (m_material != &material || m_layer != layer || m_texture != texture)
+		flush();
+	m_material = &material;
+	m_layer = layer;
+	m_texture = texture;
+}
+
+void Renderer::drawQuad(float x, float y, float width, float height, const float color[4])
+{
+	writeQuad(x, y, width, height, color, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f);
+}
+
+void Renderer::drawQuad(float x, float y, float width, float height, const float color[4], const AtlasRegion& region)
+{
+	// Atlas rows run top down while quads are built bottom up
+	writeQuad(x, y, width, height, color, region.u0, region.v1, region.u1, region.v0, 1.0f);
+}
+
+void Renderer::writeQuad(float x, float y, float width, float height, const float color[4],
+	float u0, float v0, float u1, float v1, float texIndex)
+{
+	if (m_vertexCount == m_vertexCapacity)
+		flush();
+
+	// Vertices are written in place into the mapped region rather than copied from a staging array.
+	// Batches share the region until it is full; moving on fences it, so whatever was queued from it is issued first.
+	if (!m_vertices)
+	{
+		unsigned int capacity = m_vertexBuffer.getRegionSpace() / sizeof(QuadVertex) / 4 * 4;
+		if (capacity == 0)
+		{
+			m_drawList.execute();
+			capacity = kMaxVertices;
+		}
+		m_vertexCapacity = capacity < kMaxVertices ? capacity : kMaxVertices;
+		m_vertices = (QuadVertex*)m_vertexBuffer.map(m_vertexCapacity * sizeof(QuadVertex));
+	}
+
+	const uint8_t rgba[4] =
+	{
+		(uint8_t)(color[0] * 255.0f + 0.5f),
+		(uint8_t)(color[1] * 255.0f + 0.5f),
+		(uint8_t)(color[2] * 255.0f + 0.5f),
+		(uint8_t)(color[3] * 255.0f + 0.5f)
+	};
+
+	writeQuadVertices(m_vertices + m_vertexCount, x, y, width, height, rgba, u0, v0, u1, v1, texIndex);
+
+	m_vertexCount += 4;
+	m_quadCount++;
+}
+
+void Renderer::end()
+{
+	flush();
+	m_material = nullptr;
+	m_texture = nullptr;
+}
+
+void Renderer::endFrame()
+{
+	m_vertexBuffer.fence();
+}
+
+void Renderer::resetStats()
+{
+	m_drawCalls = 0;
+	m_quadCount = 0;
+}
+
+void Renderer::flush()
+{
+	if (m_vertexCount == 0 || !m_material)
+		return;
+
+	const unsigned int offset = m_vertexBuffer.unmap(m_vertexCount * sizeof(QuadVertex));
+	const unsigned int quadCount = m_vertexCount / 4;
+
+	// The index buffer was recorded in the vertex array when it was created
+	m_drawList.submit(m_layer, m_material->GetRendererID(), m_vertexArray.getRendererID(), m_texture ? m_texture->getRendererID() : 0,
+		quadCount * 6, offset / sizeof(QuadVertex));
+
+	m_vertices = nullptr;
+	m_vertexCount = 0;
+	m_drawCalls++;
+}
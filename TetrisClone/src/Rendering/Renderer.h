@@ -1,8 +1,61 @@
 #pragma once
+#include <cstdint>
+#include "QuadVertex.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
 
+class Shader;
+class Texture;
+struct AtlasRegion;
+class DrawList;
+enum class RenderLayer : uint8_t;
+
+// Batches quads straight into a streamed vertex buffer and submits them as one draw per material.
+// The index pattern for every quad slot is built once, so a frame only writes vertices.
 class Renderer
 {
 public:
+	static constexpr unsigned int kMaxQuads = 1024;
+	static constexpr unsigned int kMaxVertices = kMaxQuads * 4;
+	static constexpr unsigned int kMaxIndices = kMaxQuads * 6;
+	// Batches the GPU may still be reading while the next one is written
+	static constexpr unsigned int kFramesInFlight = 3;
+
+	explicit Renderer(DrawList& drawList);
+
+	// Starts a batch drawn with the given shader and texture on the given layer, flushing whatever was queued for another one
+	void begin(Shader& material, RenderLayer layer, const Texture* texture = nullptr);
+	void drawQuad(float x, float y, float width, float height, const float color[4]);
+	// Draws a region of the batch's texture, tinted by color
+	void drawQuad(float x, float y, float width, float height, const float color[4], const AtlasRegion& region);
+	void end();
+	// Call once the draw list has been executed, so the vertices written this frame are fenced after their draws
+	void endFrame();
+
+	void resetStats();
+	inline unsigned int getDrawCalls() const { return m_drawCalls; }
+	inline unsigned int getQuadCount() const { return m_quadCount; }
+
 	static void glfwErrorMessageCallback(int error, const char* description);
 
+private:
+	void writeQuad(float x, float y, float width, float height, const float color[4],
+		float u0, float v0, float u1, float v1, float texIndex);
+	void flush();
+
+private:
+	VertexArray m_vertexArray;
+	VertexBuffer m_vertexBuffer;
+	IndexBuffer m_indexBuffer;
+	DrawList& m_drawList;
+	Shader* m_material;
+	const Texture* m_texture;
+	RenderLayer m_layer;
+
+	QuadVertex* m_vertices;
+	unsigned int m_vertexCount;
+	unsigned int m_vertexCapacity;
+
+	unsigned int m_drawCalls;
+	unsigned int m_quadCount;
 };
\ No newline at end of file
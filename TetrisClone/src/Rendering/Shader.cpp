@@ -1,50 +1,310 @@
 #include "Shader.h"
+#include "RenderState.h"
 #include "GL/glew.h"
 #include "GLFW/glfw3.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+#include <utility>
+
+namespace
+{
+	const char* kProgramCacheDirectory = "cache/shaders";
+	const uint32_t kProgramCacheMagic = 0x42505354; // "TSPB"
+
+	// Written ahead of the driver's binary blob in every cache file
+	struct ProgramCacheHeader
+	{
+		uint32_t magic;
+		uint32_t format;
+		uint64_t key;
+		uint32_t length;
+	};
+
+	uint64_t HashBytes(const char* data, size_t length, uint64_t hash = 14695981039346656037ull)
+	{
+		for (size_t i = 0; i < length; i++)
+			hash = (hash ^ (uint8_t)data[i]) * 1099511628211ull;
+		return hash;
+	}
+
+	uint64_t HashString(const GLubyte* text, uint64_t hash)
+	{
+		const char* s = text ? (const char*)text : "";
+		return HashBytes(s, strlen(s) + 1, hash);
+	}
+}
 
 Shader::Shader(const char* filePath)
-	: m_filePath(filePath), m_rendererID(0)
+	: m_filePath(filePath), m_rendererID(0), m_generation(0), m_pendingProgram(0), m_pendingVertex(0), m_pendingFragment(0), m_pendingCompute(0)
+{
+	std::ifstream file(filePath);
+	std::stringstream contents;
+	contents << file.rdbuf();
+
+	m_rendererID = LoadShader(filePath, contents.str());
+	CacheUniforms();
+}
+
+Shader::Shader(const char* filePath, const std::string& source)
+	: m_filePath(filePath), m_rendererID(0), m_generation(0), m_pendingProgram(0), m_pendingVertex(0), m_pendingFragment(0), m_pendingCompute(0)
+{
+	m_rendererID = LoadShader(filePath, source);
+	CacheUniforms();
+}
+
+Shader::Shader(Shader&& other) noexcept
+	: m_filePath(std::move(other.m_filePath)), m_rendererID(other.m_rendererID), m_generation(other.m_generation),
+	m_blockBindings(std::move(other.m_blockBindings)), m_pendingProgram(other.m_pendingProgram),
+	m_pendingVertex(other.m_pendingVertex), m_pendingFragment(other.m_pendingFragment), m_pendingCompute(other.m_pendingCompute),
+	m_uniforms(std::move(other.m_uniforms))
 {
-	m_rendererID = LoadShader(filePath);
+	other.m_rendererID = 0;
+	other.m_pendingProgram = 0;
+	other.m_pendingVertex = 0;
+	other.m_pendingFragment = 0;
+	other.m_pendingCompute = 0;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		m_filePath = std::move(other.m_filePath);
+		m_rendererID = other.m_rendererID;
+		m_generation = other.m_generation;
+		m_blockBindings = std::move(other.m_blockBindings);
+		m_pendingProgram = other.m_pendingProgram;
+		m_pendingVertex = other.m_pendingVertex;
+		m_pendingFragment = other.m_pendingFragment;
+		m_pendingCompute = other.m_pendingCompute;
+		m_uniforms = std::move(other.m_uniforms);
+		other.m_rendererID = 0;
+		other.m_pendingProgram = 0;
+		other.m_pendingVertex = 0;
+		other.m_pendingFragment = 0;
+		other.m_pendingCompute = 0;
+	}
+	return *this;
 }
 
 Shader::~Shader()
 {
+	Release();
+}
+
+void Shader::Release()
+{
+	DiscardReload();
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onProgramDeleted(m_rendererID);
 	glDeleteProgram(m_rendererID);
+	m_rendererID = 0;
 }
 
 void Shader::Bind() const
 {
-	glUseProgram(m_rendererID);
-
+	RenderState::useProgram(m_rendererID);
 }
 
 void Shader::Unbind() const
 {
-	glUseProgram(0);
+	RenderState::useProgram(0);
+}
+
+void Shader::SetUniform1i(const UniformName& name, int v0)
+{
+	glUniform1i(GetUniformLocation(name), v0);
+}
+
+void Shader::SetUniform1f(const UniformName& name, float v0)
+{
+	glUniform1f(GetUniformLocation(name), v0);
+}
+
+void Shader::SetUniform2f(const UniformName& name, float v0, float v1)
+{
+	glUniform2f(GetUniformLocation(name), v0, v1);
 }
 
-void Shader::SetUniform4f(const char* name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform3f(const UniformName& name, float v0, float v1, float v2)
+{
+	glUniform3f(GetUniformLocation(name), v0, v1, v2);
+}
+
+void Shader::SetUniform4f(const UniformName& name, float v0, float v1, float v2, float v3)
 {
 	glUniform4f(GetUniformLocation(name), v0, v1, v2, v3);
 }
 
-unsigned int Shader::LoadShader(const char* filePath)
+void Shader::SetUniformMat4f(const UniformName& name, const float* matrix)
+{
+	glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, matrix);
+}
+
+void Shader::SetUniform1iv(const UniformName& name, int count, const int* values)
+{
+	glUniform1iv(GetUniformLocation(name), count, values);
+}
+
+void Shader::SetUniform1fv(const UniformName& name, int count, const float* values)
+{
+	glUniform1fv(GetUniformLocation(name), count, values);
+}
+
+void Shader::SetUniform2fv(const UniformName& name, int count, const float* values)
+{
+	glUniform2fv(GetUniformLocation(name), count, values);
+}
+
+void Shader::SetUniform3fv(const UniformName& name, int count, const float* values)
+{
+	glUniform3fv(GetUniformLocation(name), count, values);
+}
+
+void Shader::SetUniform4fv(const UniformName& name, int count, const float* values)
+{
+	glUniform4fv(GetUniformLocation(name), count, values);
+}
+
+void Shader::SetUniformMat4fv(const UniformName& name, int count, const float* matrices)
+{
+	glUniformMatrix4fv(GetUniformLocation(name), count, GL_FALSE, matrices);
+}
+
+void Shader::Dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
+{
+	Bind();
+	glDispatchCompute(groupsX, groupsY, groupsZ);
+}
+
+bool Shader::BindUniformBlock(const char* blockName, unsigned int binding)
+{
+	// Kept so the binding can be restored on whatever program a reload swaps in
+	bool known = false;
+	for (BlockBinding& block : m_blockBindings)
+	{
+		if (block.name == blockName)
+		{
+			block.binding = binding;
+			known = true;
+		}
+	}
+	if (!known)
+		m_blockBindings.push_back({ blockName, binding });
+
+	const unsigned int index = glGetUniformBlockIndex(m_rendererID, blockName);
+	if (index == GL_INVALID_INDEX)
+		return false;
+
+	glUniformBlockBinding(m_rendererID, index, binding);
+	return true;
+}
+
+void Shader::BeginReload(const std::string& vertexSource, const std::string& fragmentSource, const std::string& computeSource)
+{
+	DiscardReload();
+
+	// Nothing here waits on the compiler; with parallel compile the driver finishes on its own threads
+	m_pendingProgram = glCreateProgram();
+	glProgramParameteri(m_pendingProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	if (!computeSource.empty())
+	{
+		m_pendingCompute = StartCompile(GL_COMPUTE_SHADER, computeSource.c_str());
+		glAttachShader(m_pendingProgram, m_pendingCompute);
+	}
+	else
+	{
+		m_pendingVertex = StartCompile(GL_VERTEX_SHADER, vertexSource.c_str());
+		m_pendingFragment = StartCompile(GL_FRAGMENT_SHADER, fragmentSource.c_str());
+		glAttachShader(m_pendingProgram, m_pendingVertex);
+		glAttachShader(m_pendingProgram, m_pendingFragment);
+	}
+	glLinkProgram(m_pendingProgram);
+}
+
+bool Shader::PollReload()
+{
+	if (m_pendingProgram == 0)
+		return false;
+
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		int complete = GL_FALSE;
+		glGetProgramiv(m_pendingProgram, GL_COMPLETION_STATUS_KHR, &complete);
+		if (complete == GL_FALSE)
+			return false;
+	}
+
+	// Check every stage without short circuiting so each error log is printed
+	const bool compiled = m_pendingCompute != 0 ? CheckCompile(m_pendingCompute, GL_COMPUTE_SHADER)
+		: CheckCompile(m_pendingVertex, GL_VERTEX_SHADER) & CheckCompile(m_pendingFragment, GL_FRAGMENT_SHADER);
+	if (!compiled || !CheckLink(m_pendingProgram))
+	{
+		std::cout << "Reload of " << m_filePath << " failed, keeping the previous program" << std::endl;
+		DiscardReload();
+		return false;
+	}
+
+	glDeleteShader(m_pendingVertex);
+	glDeleteShader(m_pendingFragment);
+	glDeleteShader(m_pendingCompute);
+	RenderState::onProgramDeleted(m_rendererID);
+	glDeleteProgram(m_rendererID);
+	m_rendererID = m_pendingProgram;
+	m_pendingProgram = 0;
+	m_pendingVertex = 0;
+	m_pendingFragment = 0;
+	m_pendingCompute = 0;
+
+	CacheUniforms();
+	for (const BlockBinding& block : m_blockBindings)
+	{
+		const unsigned int index = glGetUniformBlockIndex(m_rendererID, block.name.c_str());
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(m_rendererID, index, block.binding);
+	}
+
+	m_generation++;
+	std::cout << "Reloaded " << m_filePath << std::endl;
+	return true;
+}
+
+void Shader::DiscardReload()
+{
+	if (m_pendingProgram == 0)
+		return;
+
+	glDeleteShader(m_pendingVertex);
+	glDeleteShader(m_pendingFragment);
+	glDeleteShader(m_pendingCompute);
+	glDeleteProgram(m_pendingProgram);
+	m_pendingProgram = 0;
+	m_pendingVertex = 0;
+	m_pendingFragment = 0;
+	m_pendingCompute = 0;
+}
+
+bool Shader::ParseSource(const std::string& source, std::string& vertexSource, std::string& fragmentSource, std::string& computeSource)
 {
 	enum class ShaderType
 	{
-		NONE = -1, VERTEX = 0, FRAGMENT = 1
+		NONE = -1, VERTEX = 0, FRAGMENT = 1, COMPUTE = 2
 	};
 
-	std::ifstream file(filePath);
-	std::stringstream ss[2];
+	std::istringstream lines(source);
+	std::stringstream ss[3];
 	std::string line;
 	ShaderType type = ShaderType::NONE;
-	while (getline(file, line))
+	while (getline(lines, line))
 	{
 		if (line.find("#shader") != std::string::npos)
 		{
@@ -52,41 +312,195 @@ unsigned int Shader::LoadShader(const char* filePath)
 				type = ShaderType::VERTEX;
 			else if (line.find("fragment") != std::string::npos)
 				type = ShaderType::FRAGMENT;
+			else if (line.find("compute") != std::string::npos)
+				type = ShaderType::COMPUTE;
 		}
-		else
+		else if (type != ShaderType::NONE)
 		{
 			ss[(int)type] << line << '\n';
 		}
 	}
 
+	vertexSource = ss[0].str();
+	fragmentSource = ss[1].str();
+	computeSource = ss[2].str();
+	if (!computeSource.empty())
+		return vertexSource.empty() && fragmentSource.empty();
+	return !vertexSource.empty() && !fragmentSource.empty();
+}
+
+unsigned int Shader::LoadShader(const char* filePath, const std::string& source)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	// A binary is only reusable with the exact same source on the exact same driver
+	uint64_t key = HashBytes(source.data(), source.size());
+	key = HashString(glGetString(GL_VENDOR), key);
+	key = HashString(glGetString(GL_RENDERER), key);
+	key = HashString(glGetString(GL_VERSION), key);
+
+	char cacheName[32];
+	snprintf(cacheName, sizeof(cacheName), "%016llx.bin", (unsigned long long)HashBytes(filePath, strlen(filePath)));
+	const std::string cachePath = std::string(kProgramCacheDirectory) + "/" + cacheName;
+
+	unsigned int program = LoadProgramBinary(cachePath.c_str(), key);
+	const bool cached = program != 0;
+	if (!cached)
+	{
+		std::string vertexSource;
+		std::string fragmentSource;
+		std::string computeSource;
+		ParseSource(source, vertexSource, fragmentSource, computeSource);
+
+		if (computeSource.empty())
+			program = CreateShader(vertexSource.c_str(), fragmentSource.c_str());
+		else
+			program = CreateComputeShader(computeSource.c_str());
+		if (program != 0)
+			SaveProgramBinary(program, cachePath.c_str(), key);
+	}
 
-	return CreateShader(ss[0].str().c_str(), ss[1].str().c_str());
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Loaded " << filePath << (cached ? " from binary cache" : " from source") << " in " << elapsed.count() << " ms" << std::endl;
+	return program;
 }
 
 unsigned int Shader::CreateShader(const char* vertexShader, const char* fragmentShader)
 {
-	unsigned int program = glCreateProgram();
 	unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
 	unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+	if (vs == 0 || fs == 0)
+	{
+		glDeleteShader(vs);
+		glDeleteShader(fs);
+		return 0;
+	}
 
+	// Ask the driver to keep the linked binary around so it can be written to the cache
+	unsigned int program = glCreateProgram();
+	glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glAttachShader(program, vs);
 	glAttachShader(program, fs);
 	glLinkProgram(program);
-	glValidateProgram(program);
 
 	glDeleteShader(vs);
 	glDeleteShader(fs);
 
+	if (!CheckLink(program))
+	{
+		glDeleteProgram(program);
+		return 0;
+	}
+
+#ifdef _DEBUG
+	glValidateProgram(program);
+#endif
+
 	return program;
 }
 
+unsigned int Shader::CreateComputeShader(const char* computeShader)
+{
+	unsigned int cs = CompileShader(GL_COMPUTE_SHADER, computeShader);
+	if (cs == 0)
+		return 0;
+
+	unsigned int program = glCreateProgram();
+	glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glAttachShader(program, cs);
+	glLinkProgram(program);
+	glDeleteShader(cs);
+
+	if (!CheckLink(program))
+	{
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+unsigned int Shader::LoadProgramBinary(const char* cachePath, uint64_t key)
+{
+	if (!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+		return 0;
+
+	std::ifstream file(cachePath, std::ios::binary);
+	if (!file)
+		return 0;
+
+	ProgramCacheHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || header.magic != kProgramCacheMagic || header.key != key)
+		return 0;
+
+	std::vector<char> binary(header.length);
+	if (!file.read(binary.data(), header.length))
+		return 0;
+
+	// Drivers may still reject a binary they wrote, in which case the source path rebuilds it
+	unsigned int program = glCreateProgram();
+	glProgramBinary(program, header.format, binary.data(), header.length);
+
+	int linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+void Shader::SaveProgramBinary(unsigned int program, const char* cachePath, uint64_t key)
+{
+	if (!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+		return;
+
+	int linked = GL_FALSE;
+	int length = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (linked == GL_FALSE || length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	std::error_code error;
+	std::filesystem::create_directories(kProgramCacheDirectory, error);
+
+	std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return;
+
+	const ProgramCacheHeader header = { kProgramCacheMagic, format, key, (uint32_t)length };
+	file.write((const char*)&header, sizeof(header));
+	file.write(binary.data(), length);
+}
+
 unsigned int Shader::CompileShader(unsigned int type, const char* source)
+{
+	unsigned int id = StartCompile(type, source);
+	if (!CheckCompile(id, type))
+	{
+		glDeleteShader(id);
+		return 0;
+	}
+
+	return id;
+}
+
+unsigned int Shader::StartCompile(unsigned int type, const char* source)
 {
 	unsigned int id = glCreateShader(type);
 	const char* src = source;
 	glShaderSource(id, 1, &src, nullptr);
 	glCompileShader(id);
+	return id;
+}
 
+bool Shader::CheckCompile(unsigned int id, unsigned int type)
+{
 	int result;
 	glGetShaderiv(id, GL_COMPILE_STATUS, &result);
 	if (result == GL_FALSE)
@@ -95,19 +509,73 @@ unsigned int Shader::CompileShader(unsigned int type, const char* source)
 		glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
 		char* message = (char*)alloca(length * sizeof(char));
 		glGetShaderInfoLog(id, length, &length, message);
-		std::cout << "Failed to compile" << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << "shader!" << std::endl;
+		const char* stage = type == GL_VERTEX_SHADER ? "vertex" : type == GL_FRAGMENT_SHADER ? "fragment" : "compute";
+		std::cout << "Failed to compile " << stage << " shader in " << m_filePath << "!" << std::endl;
 		std::cout << message << std::endl;
-		glDeleteShader(id);
-		return 0;
+		return false;
 	}
 
-	return id;
+	return true;
+}
+
+bool Shader::CheckLink(unsigned int program)
+{
+	int result;
+	glGetProgramiv(program, GL_LINK_STATUS, &result);
+	if (result == GL_FALSE)
+	{
+		int length;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+		char* message = (char*)alloca(length * sizeof(char));
+		glGetProgramInfoLog(program, length, &length, message);
+		std::cout << "Failed to link " << m_filePath << "!" << std::endl;
+		std::cout << message << std::endl;
+		return false;
+	}
+
+	return true;
 }
 
-unsigned int Shader::GetUniformLocation(const char* name)
+void Shader::CacheUniforms()
 {
-	int location = glGetUniformLocation(m_rendererID, name);
-	if (location == -1)
-		std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
-	return location;
+	int count = 0;
+	int maxLength = 0;
+	glGetProgramiv(m_rendererID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(m_rendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	m_uniforms.clear();
+	m_uniforms.reserve(count);
+	char* name = (char*)alloca(maxLength > 0 ? maxLength : 1);
+	for (int i = 0; i < count; i++)
+	{
+		int length = 0;
+		int size = 0;
+		unsigned int type = 0;
+		glGetActiveUniform(m_rendererID, i, maxLength, &length, &size, &type, name);
+
+		// Members of uniform blocks have no location and are set through their buffer instead
+		const int location = glGetUniformLocation(m_rendererID, name);
+		if (location == -1)
+			continue;
+
+		// Arrays are reported as "name[0]", but are set through the bare name
+		if (length > 3 && name[length - 1] == ']' && name[length - 2] == '0' && name[length - 3] == '[')
+			length -= 3;
+
+		m_uniforms.push_back({ UniformName::Hash(name, length), location });
+	}
+}
+
+int Shader::GetUniformLocation(const UniformName& name)
+{
+	for (const UniformSlot& slot : m_uniforms)
+	{
+		if (slot.hash == name.hash)
+			return slot.location;
+	}
+
+	// Remember the miss so the warning is printed once rather than on every call
+	std::cout << "Warning: uniform '" << name.name << "' doesn't exist!" << std::endl;
+	m_uniforms.push_back({ name.hash, -1 });
+	return -1;
 }
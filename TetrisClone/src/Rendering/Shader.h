@@ -1,25 +1,116 @@
 #pragma once
+#include <cstdint>
+#include <vector>
+#include <string>
+
+// A uniform name with its FNV-1a hash. Declared constexpr, the hash is computed at compile time
+// and a lookup never touches the string.
+struct UniformName
+{
+	uint32_t hash;
+	const char* name;
+
+	constexpr UniformName(const char* n) : hash(Hash(n)), name(n) {}
+
+	static constexpr uint32_t Hash(const char* s, uint32_t length = 0xFFFFFFFFu)
+	{
+		uint32_t h = 2166136261u;
+		for (uint32_t i = 0; i < length && s[i] != '\0'; i++)
+			h = (h ^ (uint8_t)s[i]) * 16777619u;
+		return h;
+	}
+};
 
 class Shader
 {
 public:
 	Shader(const char* filePath);
+	// Builds the program from the file's contents already read into memory, such as by the asset loader
+	Shader(const char* filePath, const std::string& source);
 	~Shader();
+	// Owns its GL object, so it can be moved but never copied
+	Shader(const Shader&) = delete;
+	Shader& operator=(const Shader&) = delete;
+	Shader(Shader&& other) noexcept;
+	Shader& operator=(Shader&& other) noexcept;
 
 	void Bind() const;
 	void Unbind() const;
 
-	void SetUniform4f(const char* name, float v0, float v1, float v2, float v3);
+	void SetUniform1i(const UniformName& name, int v0);
+	void SetUniform1f(const UniformName& name, float v0);
+	void SetUniform2f(const UniformName& name, float v0, float v1);
+	void SetUniform3f(const UniformName& name, float v0, float v1, float v2);
+	void SetUniform4f(const UniformName& name, float v0, float v1, float v2, float v3);
+	void SetUniformMat4f(const UniformName& name, const float* matrix);
+
+	void SetUniform1iv(const UniformName& name, int count, const int* values);
+	void SetUniform1fv(const UniformName& name, int count, const float* values);
+	void SetUniform2fv(const UniformName& name, int count, const float* values);
+	void SetUniform3fv(const UniformName& name, int count, const float* values);
+	void SetUniform4fv(const UniformName& name, int count, const float* values);
+	void SetUniformMat4fv(const UniformName& name, int count, const float* matrices);
+
+	// Compute programs only. Binds the program and runs the given number of work groups.
+	void Dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) const;
 
+	// Compiles and links a replacement program without waiting on the driver. PollReload swaps it in
+	// once linking has finished, or throws it away with its log printed if it failed, so the current
+	// program stays live either way.
+	void BeginReload(const std::string& vertexSource, const std::string& fragmentSource, const std::string& computeSource);
+	bool PollReload();
+	inline bool IsReloadPending() const { return m_pendingProgram != 0; }
+
+	// Splits a .shader file into its "#shader vertex", "#shader fragment" and "#shader compute" sections.
+	// A file holds either a vertex and fragment pair or a compute stage on its own.
+	static bool ParseSource(const std::string& source, std::string& vertexSource, std::string& fragmentSource, std::string& computeSource);
+
+	inline unsigned int GetRendererID() const { return m_rendererID; }
+	inline const std::string& GetFilePath() const { return m_filePath; }
+	// Bumped every time a reload swaps in a new program, whose plain uniforms then need setting again
+	inline unsigned int GetGeneration() const { return m_generation; }
+
+	// Points a uniform block at a binding slot shared with a UniformBuffer, returning false if the program has no such block
+	bool BindUniformBlock(const char* blockName, unsigned int binding);
 
 private:
-	unsigned int LoadShader(const char* filePath);
+	struct UniformSlot
+	{
+		uint32_t hash;
+		int location;
+	};
+
+	struct BlockBinding
+	{
+		std::string name;
+		unsigned int binding;
+	};
+
+	unsigned int LoadShader(const char* filePath, const std::string& source);
 	unsigned int CreateShader(const char* vertexShader, const char* fragmentShader);
+	unsigned int CreateComputeShader(const char* computeShader);
 	unsigned int CompileShader(unsigned int type, const char* source);
+	unsigned int StartCompile(unsigned int type, const char* source);
+	bool CheckCompile(unsigned int id, unsigned int type);
+	bool CheckLink(unsigned int program);
+	void DiscardReload();
+	void Release();
+	unsigned int LoadProgramBinary(const char* cachePath, uint64_t key);
+	void SaveProgramBinary(unsigned int program, const char* cachePath, uint64_t key);
+	void CacheUniforms();
 
-	unsigned int GetUniformLocation(const char* name);
+	int GetUniformLocation(const UniformName& name);
 
 private:
-	const char* m_filePath;
+	std::string m_filePath;
 	unsigned int m_rendererID;
+	unsigned int m_generation;
+	std::vector<BlockBinding> m_blockBindings;
+
+	unsigned int m_pendingProgram;
+	unsigned int m_pendingVertex;
+	unsigned int m_pendingFragment;
+	unsigned int m_pendingCompute;
+	// Active uniform locations resolved once after linking
+	std::vector<UniformSlot> m_uniforms;
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "ShaderLibrary.h"
+#include "Shader.h"
+#include "GL/glew.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+ShaderLibrary::ShaderLibrary() : m_running(true)
+{
+	// Let the driver compile and link on its own threads so polling for completion never blocks
+	if (GLEW_KHR_parallel_shader_compile)
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
+	m_worker = std::thread(&ShaderLibrary::watchFiles, this);
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+	m_running = false;
+	m_worker.join();
+
+	for (Shader* shader : m_shaders)
+		delete shader;
+	m_shaders.clear();
+}
+
+Shader* ShaderLibrary::load(const char* filePath)
+{
+	return add(new Shader(filePath));
+}
+
+Shader* ShaderLibrary::add(Shader* shader)
+{
+	m_shaders.push_back(shader);
+	m_watcher.watch(shader->GetFilePath());
+	return shader;
+}
+
+bool ShaderLibrary::update()
+{
+	std::vector<ParsedSource> parsed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		parsed.swap(m_parsed);
+	}
+
+	for (const ParsedSource& source : parsed)
+	{
+		for (Shader* shader : m_shaders)
+		{
+			if (shader->GetFilePath() == source.path)
+				shader->BeginReload(source.vertex, source.fragment, source.compute);
+		}
+	}
+
+	bool reloading = !parsed.empty();
+	for (Shader* shader : m_shaders)
+	{
+		if (shader->IsReloadPending())
+		{
+			shader->PollReload();
+			reloading = true;
+		}
+	}
+	return reloading;
+}
+
+void ShaderLibrary::watchFiles()
+{
+	while (m_running)
+	{
+		// Short timeout so shutdown does not wait long on an idle watcher
+		std::vector<std::string> changed = m_watcher.waitForChanges(100);
+		std::sort(changed.begin(), changed.end());
+		changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+		for (const std::string& path : changed)
+		{
+			std::ifstream file(path);
+			std::stringstream contents;
+			contents << file.rdbuf();
+
+			ParsedSource source;
+			source.path = path;
+			if (!Shader::ParseSource(contents.str(), source.vertex, source.fragment, source.compute))
+			{
+				// Caught mid-save or missing a stage; the next write will trigger another attempt
+				std::cout << "Skipping reload of " << path << ", it has neither a vertex and fragment pair nor a compute section" << std::endl;
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_parsed.push_back(std::move(source));
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include "Core/FileWatcher.h"
+
+class Shader;
+
+// Owns every Shader and reloads them when their files change. A worker thread watches the files
+// and parses the new sources, and update swaps in the recompiled programs on the GL thread
+// once the driver has finished linking them.
+class ShaderLibrary
+{
+public:
+	ShaderLibrary();
+	~ShaderLibrary();
+
+	Shader* load(const char* filePath);
+	// Takes ownership of a shader built elsewhere, such as by the asset loader, and watches its file
+	Shader* add(Shader* shader);
+
+	// Call once per frame on the thread that owns the GL context. Returns true while a reload is
+	// being started or finished, which allocates.
+	bool update();
+
+private:
+	struct ParsedSource
+	{
+		std::string path;
+		std::string vertex;
+		std::string fragment;
+		std::string compute;
+	};
+
+	void watchFiles();
+
+private:
+	std::vector<Shader*> m_shaders;
+	FileWatcher m_watcher;
+
+	std::thread m_worker;
+	std::atomic<bool> m_running;
+	std::mutex m_mutex;
+	std::vector<ParsedSource> m_parsed;
+};
\ No newline at end of file
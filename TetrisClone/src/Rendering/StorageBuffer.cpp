@@ -0,0 +1,64 @@
+#include "StorageBuffer.h"
+#include "RenderState.h"
+#include "GL/glew.h"
+
+StorageBuffer::StorageBuffer(unsigned int size, unsigned int binding) : m_size(size), m_binding(binding)
+{
+	glGenBuffers(1, &m_rendererID);
+	RenderState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_rendererID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+	clear();
+
+	// Like uniform buffers, it stays attached to its binding slot for every program that reads it
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_rendererID);
+}
+
+StorageBuffer::StorageBuffer(StorageBuffer&& other) noexcept
+	: m_rendererID(other.m_rendererID), m_size(other.m_size), m_binding(other.m_binding)
+{
+	other.m_rendererID = 0;
+}
+
+StorageBuffer& StorageBuffer::operator=(StorageBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_rendererID = other.m_rendererID;
+		m_size = other.m_size;
+		m_binding = other.m_binding;
+		other.m_rendererID = 0;
+	}
+	return *this;
+}
+
+StorageBuffer::~StorageBuffer()
+{
+	release();
+}
+
+void StorageBuffer::release()
+{
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onBufferDeleted(m_rendererID);
+	glDeleteBuffers(1, &m_rendererID);
+	m_rendererID = 0;
+}
+
+void StorageBuffer::clear()
+{
+	RenderState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_rendererID);
+	glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
+void StorageBuffer::bind() const
+{
+	RenderState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_rendererID);
+}
+
+void StorageBuffer::unbind() const
+{
+	RenderState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// A shader storage buffer attached to a fixed binding slot, for data written and read on the GPU
+// such as particle state. Needs GL 4.3.
+class StorageBuffer
+{
+public:
+	StorageBuffer() : m_rendererID(0), m_size(0), m_binding(0) {}
+	// Allocates size bytes cleared to zero
+	StorageBuffer(unsigned int size, unsigned int binding);
+	~StorageBuffer();
+	// Owns its GL object, so it can be moved but never copied
+	StorageBuffer(const StorageBuffer&) = delete;
+	StorageBuffer& operator=(const StorageBuffer&) = delete;
+	StorageBuffer(StorageBuffer&& other) noexcept;
+	StorageBuffer& operator=(StorageBuffer&& other) noexcept;
+
+	// Zeroes the whole buffer on the GPU without uploading anything
+	void clear();
+
+	void bind() const;
+	void unbind() const;
+
+	inline bool isValid() const { return m_rendererID != 0; }
+	inline unsigned int getSize() const { return m_size; }
+	inline unsigned int getBinding() const { return m_binding; }
+
+private:
+	void release();
+
+private:
+	unsigned int m_rendererID;
+	unsigned int m_size;
+	unsigned int m_binding;
+};
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "TextLayer.h"
+#include "Font.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "VertexBufferLayout.h"
+#include "DrawList.h"
+#include <cstring>
+
+TextLayer::TextLayer(const Font& font, const Texture& atlas, RenderLayer layer)
+	: m_font(font), m_atlas(atlas), m_layer(layer), m_vertexBuffer(sizeof(m_vertices)), m_stringCount(0), m_glyphCount(0),
+	m_dirtyFirst(kMaxGlyphs), m_dirtyLast(-1)
+{
+	// Unused glyphs stay degenerate quads at the origin and draw nothing
+	memset(m_vertices, 0, sizeof(m_vertices));
+
+	m_vertexBuffer.setSubData(0, m_vertices, sizeof(m_vertices));
+	VertexBufferLayout layout;
+	layout.push<float>(2);
+	layout.push<float>(2);
+	layout.push<unsigned char>(4);
+	layout.push<float>(1);
+	m_vertexArray.addBuffer(m_vertexBuffer, layout);
+
+	unsigned int indices[kMaxGlyphs * 6];
+	for (unsigned int i = 0; i < kMaxGlyphs; i++)
+	{
+		const unsigned int base = i * 4;
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 3;
+		indices[i * 6 + 5] = base + 0;
+	}
+	m_indexBuffer = IndexBuffer(indices, kMaxGlyphs * 6);
+	m_vertexArray.setIndexBuffer(m_indexBuffer);
+
+	m_vertexArray.unbind();
+	m_vertexBuffer.unbind();
+	m_indexBuffer.unbind();
+}
+
+int TextLayer::addString(float x, float y, float glyphWidth, float glyphHeight, const float color[4], int capacity)
+{
+	if (capacity > kMaxStringLength)
+		capacity = kMaxStringLength;
+	if (m_stringCount == kMaxStrings || m_glyphCount + capacity > kMaxGlyphs)
+		return -1;
+
+	TextString& string = m_strings[m_stringCount];
+	string.x = x;
+	string.y = y;
+	string.glyphWidth = glyphWidth;
+	string.glyphHeight = glyphHeight;
+	for (int i = 0; i < 4; i++)
+		string.color[i] = (uint8_t)(color[i] * 255.0f + 0.5f);
+	string.firstGlyph = m_glyphCount;
+	string.capacity = capacity;
+	string.text[0] = '\0';
+
+	m_glyphCount += capacity;
+	return m_stringCount++;
+}
+
+void TextLayer::setText(int string, const char* text)
+{
+	if (string < 0 || string >= m_stringCount)
+		return;
+
+	TextString& target = m_strings[string];
+	const size_t length = strnlen(text, target.capacity);
+	if (strncmp(target.text, text, length) == 0 && target.text[length] == '\0')
+		return;
+
+	memcpy(target.text, text, length);
+	target.text[length] = '\0';
+	layout(string);
+}
+
+void TextLayer::layout(int index)
+{
+	const TextString& string = m_strings[index];
+
+	// Quads extend past the glyph cell by the field's margin so that the outline lands on the cell
+	const float marginX = string.glyphWidth * Font::kMarginX;
+	const float marginY = string.glyphHeight * Font::kMarginY;
+	const float advance = string.glyphWidth * (Font::kGlyphColumns + 1) / Font::kGlyphColumns;
+
+	QuadVertex* quad = m_vertices + string.firstGlyph * 4;
+	memset(quad, 0, string.capacity * 4 * sizeof(QuadVertex));
+
+	float penX = string.x;
+	for (int i = 0; string.text[i] != '\0'; i++, penX += advance)
+	{
+		if (string.text[i] == ' ')
+			continue;
+
+		// Atlas rows run top down while quads are built bottom up
+		const AtlasRegion& region = m_font.getGlyph(string.text[i]);
+		writeQuadVertices(quad + i * 4, penX - marginX, string.y - string.glyphHeight - marginY,
+			string.glyphWidth + 2.0f * marginX, string.glyphHeight + 2.0f * marginY, string.color,
+			region.u0, region.v1, region.u1, region.v0, 2.0f);
+	}
+
+	if (string.firstGlyph < m_dirtyFirst)
+		m_dirtyFirst = string.firstGlyph;
+	if (string.firstGlyph + string.capacity - 1 > m_dirtyLast)
+		m_dirtyLast = string.firstGlyph + string.capacity - 1;
+}
+
+void TextLayer::draw(DrawList& drawList, const Shader& shader)
+{
+	if (m_dirtyFirst <= m_dirtyLast)
+	{
+		const unsigned int offset = m_dirtyFirst * 4 * sizeof(QuadVertex);
+		const unsigned int size = (m_dirtyLast - m_dirtyFirst + 1) * 4 * sizeof(QuadVertex);
+		m_vertexBuffer.setSubData(offset, m_vertices + m_dirtyFirst * 4, size);
+		m_dirtyFirst = kMaxGlyphs;
+		m_dirtyLast = -1;
+	}
+
+	if (m_glyphCount > 0)
+		drawList.submit(m_layer, shader.GetRendererID(), m_vertexArray.getRendererID(), m_atlas.getRendererID(), m_glyphCount * 6);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include "QuadVertex.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+
+class Font;
+class Texture;
+enum class RenderLayer : uint8_t;
+class Shader;
+class DrawList;
+
+// Strings drawn from one font with a single draw call. Each string owns a fixed run of glyph
+// quads in a vertex buffer that lives across frames: setting the same text again costs a
+// comparison, and new text only rewrites and uploads that string's run. Nothing allocates
+// after construction, so a score can be set every frame.
+class TextLayer
+{
+public:
+	static constexpr int kMaxGlyphs = 256;
+	static constexpr int kMaxStrings = 16;
+	static constexpr int kMaxStringLength = 63;
+
+	TextLayer(const Font& font, const Texture& atlas, RenderLayer layer);
+
+	// Reserves room for up to capacity characters with the first glyph's top left at x, y.
+	// Returns the handle to pass to setText, or -1 when the layer is out of room.
+	int addString(float x, float y, float glyphWidth, float glyphHeight, const float color[4], int capacity);
+	// Text beyond the string's capacity is cut off
+	void setText(int string, const char* text);
+
+	// Uploads whatever changed and submits every string as one draw
+	void draw(DrawList& drawList, const Shader& shader);
+
+private:
+	void layout(int string);
+
+private:
+	struct TextString
+	{
+		float x, y;
+		float glyphWidth, glyphHeight;
+		uint8_t color[4];
+		int firstGlyph;
+		int capacity;
+		char text[kMaxStringLength + 1];
+	};
+
+	const Font& m_font;
+	const Texture& m_atlas;
+	RenderLayer m_layer;
+
+	VertexArray m_vertexArray;
+	VertexBuffer m_vertexBuffer;
+	IndexBuffer m_indexBuffer;
+
+	TextString m_strings[kMaxStrings];
+	int m_stringCount;
+	QuadVertex m_vertices[kMaxGlyphs * 4];
+	int m_glyphCount;
+
+	// Glyph range rewritten since the last upload, empty when first exceeds last
+	int m_dirtyFirst;
+	int m_dirtyLast;
+};
\ No newline at end of file
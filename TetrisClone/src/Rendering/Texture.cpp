@@ -0,0 +1,92 @@
+#include "Texture.h"
+#include "RenderState.h"
+#include "GL/glew.h"
+
+Texture::Texture(int width, int height, int levels)
+	: m_rendererID(0), m_width(width), m_height(height)
+{
+	const int maxLevels = getMaxLevels(width, height);
+	m_levels = levels < 1 ? 1 : (levels > maxLevels ? maxLevels : levels);
+
+	glGenTextures(1, &m_rendererID);
+	RenderState::bindTexture(0, GL_TEXTURE_2D, m_rendererID);
+	glTexStorage2D(GL_TEXTURE_2D, m_levels, GL_RGBA8, m_width, m_height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+Texture::Texture(Texture&& other) noexcept
+	: m_rendererID(other.m_rendererID), m_width(other.m_width), m_height(other.m_height), m_levels(other.m_levels)
+{
+	other.m_rendererID = 0;
+}
+
+Texture& Texture::operator=(Texture&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_rendererID = other.m_rendererID;
+		m_width = other.m_width;
+		m_height = other.m_height;
+		m_levels = other.m_levels;
+		other.m_rendererID = 0;
+	}
+	return *this;
+}
+
+Texture::~Texture()
+{
+	release();
+}
+
+void Texture::release()
+{
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onTextureDeleted(m_rendererID);
+	glDeleteTextures(1, &m_rendererID);
+	m_rendererID = 0;
+}
+
+void Texture::setData(int x, int y, int width, int height, const void* data, int rowLength)
+{
+	RenderState::bindTexture(0, GL_TEXTURE_2D, m_rendererID);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+void Texture::generateMipmaps()
+{
+	if (m_levels < 2)
+		return;
+
+	RenderState::bindTexture(0, GL_TEXTURE_2D, m_rendererID);
+	glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void Texture::bind(unsigned int unit) const
+{
+	RenderState::bindTexture(unit, GL_TEXTURE_2D, m_rendererID);
+}
+
+void Texture::unbind(unsigned int unit) const
+{
+	RenderState::bindTexture(unit, GL_TEXTURE_2D, 0);
+}
+
+int Texture::getMaxLevels(int width, int height)
+{
+	int size = width > height ? width : height;
+	int levels = 1;
+	while (size > 1)
+	{
+		size >>= 1;
+		levels++;
+	}
+	return levels;
+}
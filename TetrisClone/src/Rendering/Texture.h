@@ -0,0 +1,40 @@
+#pragma once
+
+// Immutable RGBA8 texture. Storage for every mip level is allocated up front, so only the
+// contents can change afterwards.
+class Texture
+{
+public:
+	Texture(int width, int height, int levels = 1);
+	~Texture();
+	// Owns its GL object, so it can be moved but never copied
+	Texture(const Texture&) = delete;
+	Texture& operator=(const Texture&) = delete;
+	Texture(Texture&& other) noexcept;
+	Texture& operator=(Texture&& other) noexcept;
+
+	// Replaces a rectangle of the base level. Rows in data are rowLength pixels apart, or width if zero.
+	void setData(int x, int y, int width, int height, const void* data, int rowLength = 0);
+	// Rebuilds every level below the base one from it
+	void generateMipmaps();
+
+	void bind(unsigned int unit = 0) const;
+	void unbind(unsigned int unit = 0) const;
+
+	inline int getWidth() const { return m_width; }
+	inline int getHeight() const { return m_height; }
+	inline int getLevels() const { return m_levels; }
+	inline unsigned int getRendererID() const { return m_rendererID; }
+
+	// Number of levels in a full mip chain for the given size
+	static int getMaxLevels(int width, int height);
+
+private:
+	void release();
+
+private:
+	unsigned int m_rendererID;
+	int m_width;
+	int m_height;
+	int m_levels;
+};
\ No newline at end of file
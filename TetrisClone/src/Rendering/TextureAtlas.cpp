@@ -0,0 +1,72 @@
+#include "TextureAtlas.h"
+#include "Texture.h"
+#include <cstring>
+
+TextureAtlas::TextureAtlas(int width, int height)
+	: m_packer(width, height), m_width(width), m_height(height),
+	m_dirtyMinX(width), m_dirtyMinY(height), m_dirtyMaxX(0), m_dirtyMaxY(0)
+{
+	m_pixels = new uint8_t[width * height * 4];
+	memset(m_pixels, 0, width * height * 4);
+	m_texture = new Texture(width, height, kMipLevels);
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	delete m_texture;
+	delete[] m_pixels;
+}
+
+bool TextureAtlas::add(int width, int height, const uint8_t* pixels, AtlasRegion& region)
+{
+	int x, y;
+	if (!m_packer.pack(width + 2 * kPadding, height + 2 * kPadding, x, y))
+		return false;
+
+	// Copy the image with its border pixels repeated out to the edge of the padding
+	const int paddedWidth = width + 2 * kPadding;
+	const int paddedHeight = height + 2 * kPadding;
+	for (int row = 0; row < paddedHeight; row++)
+	{
+		int sourceRow = row - kPadding;
+		sourceRow = sourceRow < 0 ? 0 : (sourceRow >= height ? height - 1 : sourceRow);
+		uint8_t* destination = m_pixels + ((y + row) * m_width + x) * 4;
+		const uint8_t* source = pixels + sourceRow * width * 4;
+
+		for (int column = 0; column < kPadding; column++)
+			memcpy(destination + column * 4, source, 4);
+		memcpy(destination + kPadding * 4, source, width * 4);
+		for (int column = kPadding + width; column < paddedWidth; column++)
+			memcpy(destination + column * 4, source + (width - 1) * 4, 4);
+	}
+
+	if (x < m_dirtyMinX) m_dirtyMinX = x;
+	if (y < m_dirtyMinY) m_dirtyMinY = y;
+	if (x + paddedWidth > m_dirtyMaxX) m_dirtyMaxX = x + paddedWidth;
+	if (y + paddedHeight > m_dirtyMaxY) m_dirtyMaxY = y + paddedHeight;
+
+	region.x = x + kPadding;
+	region.y = y + kPadding;
+	region.width = width;
+	region.height = height;
+	region.u0 = (float)region.x / m_width;
+	region.v0 = (float)region.y / m_height;
+	region.u1 = (float)(region.x + width) / m_width;
+	region.v1 = (float)(region.y + height) / m_height;
+	return true;
+}
+
+void TextureAtlas::upload()
+{
+	if (m_dirtyMinX >= m_dirtyMaxX || m_dirtyMinY >= m_dirtyMaxY)
+		return;
+
+	const uint8_t* first = m_pixels + (m_dirtyMinY * m_width + m_dirtyMinX) * 4;
+	m_texture->setData(m_dirtyMinX, m_dirtyMinY, m_dirtyMaxX - m_dirtyMinX, m_dirtyMaxY - m_dirtyMinY, first, m_width);
+	m_texture->generateMipmaps();
+
+	m_dirtyMinX = m_width;
+	m_dirtyMinY = m_height;
+	m_dirtyMaxX = 0;
+	m_dirtyMaxY = 0;
+}
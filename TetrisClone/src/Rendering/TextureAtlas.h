@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include "RectPacker.h"
+
+class Texture;
+
+// Where an image ended up in an atlas, in pixels and in texture coordinates
+struct AtlasRegion
+{
+	float u0, v0, u1, v1;
+	int x, y, width, height;
+};
+
+// Packs many small RGBA images into one mipmapped texture so that everything drawn from them
+// can share a single texture binding. Images are kept in a CPU copy and only the area touched
+// since the last upload is sent to the GPU.
+class TextureAtlas
+{
+public:
+	// Pixels around every image, filled by extending its edges so filtering and the smaller
+	// mip levels never pick up a neighbour. Each mip level halves it, so it bounds the level count.
+	static constexpr int kPadding = 4;
+	static constexpr int kMipLevels = 3;
+
+	TextureAtlas(int width, int height);
+	~TextureAtlas();
+
+	// Copies a width by height RGBA image into the atlas. Returns false when it is full.
+	bool add(int width, int height, const uint8_t* pixels, AtlasRegion& region);
+	// Sends everything added since the last call to the texture and rebuilds its mipmaps
+	void upload();
+
+	inline const Texture& getTexture() const { return *m_texture; }
+	inline float getOccupancy() const { return m_packer.getOccupancy(); }
+
+private:
+	RectPacker m_packer;
+	int m_width;
+	int m_height;
+	uint8_t* m_pixels;
+	Texture* m_texture;
+
+	// Bounds of the area changed since the last upload, empty when minimum exceeds maximum
+	int m_dirtyMinX, m_dirtyMinY, m_dirtyMaxX, m_dirtyMaxY;
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "UniformBuffer.h"
+#include "RenderState.h"
+#include "GL/glew.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int binding) : m_size(size), m_binding(binding)
+{
+	glGenBuffers(1, &m_rendererID);
+	RenderState::bindBuffer(GL_UNIFORM_BUFFER, m_rendererID);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+
+	// The buffer stays attached to its binding slot, so programs pick it up without rebinding
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_rendererID);
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+	: m_rendererID(other.m_rendererID), m_size(other.m_size), m_binding(other.m_binding)
+{
+	other.m_rendererID = 0;
+}
+
+UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_rendererID = other.m_rendererID;
+		m_size = other.m_size;
+		m_binding = other.m_binding;
+		other.m_rendererID = 0;
+	}
+	return *this;
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	release();
+}
+
+void UniformBuffer::release()
+{
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onBufferDeleted(m_rendererID);
+	glDeleteBuffers(1, &m_rendererID);
+	m_rendererID = 0;
+}
+
+void UniformBuffer::setData(const void* data, unsigned int size)
+{
+	RenderState::bindBuffer(GL_UNIFORM_BUFFER, m_rendererID);
+	glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+}
+
+void UniformBuffer::bind() const
+{
+	RenderState::bindBuffer(GL_UNIFORM_BUFFER, m_rendererID);
+}
+
+void UniformBuffer::unbind() const
+{
+	RenderState::bindBuffer(GL_UNIFORM_BUFFER, 0);
+}
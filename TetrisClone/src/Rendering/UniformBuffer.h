@@ -0,0 +1,39 @@
+#pragma once
+
+// Per-frame values shared by every program through the "Frame" uniform block, laid out std140
+struct FrameUniforms
+{
+	float projection[16];
+	// Seconds since start, then three unused floats of std140 padding
+	float time[4];
+};
+
+class UniformBuffer
+{
+public:
+	static constexpr unsigned int kFrameBinding = 0;
+
+	UniformBuffer() : m_rendererID(0), m_size(0), m_binding(0) {}
+	UniformBuffer(unsigned int size, unsigned int binding);
+	~UniformBuffer();
+	// Owns its GL object, so it can be moved but never copied
+	UniformBuffer(const UniformBuffer&) = delete;
+	UniformBuffer& operator=(const UniformBuffer&) = delete;
+	UniformBuffer(UniformBuffer&& other) noexcept;
+	UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+	void setData(const void* data, unsigned int size);
+
+	void bind() const;
+	void unbind() const;
+
+	inline unsigned int getBinding() const { return m_binding; }
+
+private:
+	void release();
+
+private:
+	unsigned int m_rendererID;
+	unsigned int m_size;
+	unsigned int m_binding;
+};
\ No newline at end of file
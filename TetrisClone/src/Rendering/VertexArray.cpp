@@ -1,38 +1,84 @@
 #include "VertexArray.h"
+#include "VertexBufferLayout.h"
+#include "IndexBuffer.h"
 #include "Renderer.h"
+#include "RenderState.h"
+#include <cstdint>
 
-VertexArray::VertexArray()
+VertexArray::VertexArray() : m_attributeCount(0)
 {
 	glGenVertexArrays(1, &m_rendererID);
 }
 
+VertexArray::VertexArray(VertexArray&& other) noexcept : m_rendererID(other.m_rendererID), m_attributeCount(other.m_attributeCount)
+{
+	other.m_rendererID = 0;
+	other.m_attributeCount = 0;
+}
+
+VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_rendererID = other.m_rendererID;
+		m_attributeCount = other.m_attributeCount;
+		other.m_rendererID = 0;
+		other.m_attributeCount = 0;
+	}
+	return *this;
+}
+
 VertexArray::~VertexArray()
 {
+	release();
+}
+
+void VertexArray::release()
+{
+	if (m_rendererID == 0)
+		return;
+
+	RenderState::onVertexArrayDeleted(m_rendererID);
 	glDeleteVertexArrays(1, &m_rendererID);
+	m_rendererID = 0;
 }
 
 void VertexArray::addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
 {
 	bind();
 	vb.bind();
-	const auto& elements = layout.getElements();
+	const VertexBufferElement* elements = layout.getElements();
 	unsigned int offset = 0;
-	for (unsigned int i = 0; i < elements.size(); i++)
+	for (unsigned int i = 0; i < layout.getCount(); i++)
 	{
+		// Attributes from later buffers follow on from the ones already added
 		const auto& element = elements[i];
-		glEnableVertexAttribArray(i);
-		glVertexAttribPointer(i, element.count, element.type, 
-			element.normalized, layout.getStride(), (const void*)offset);
+		const unsigned int index = m_attributeCount + i;
+		glEnableVertexAttribArray(index);
+		if (element.isInteger())
+			glVertexAttribIPointer(index, element.count, element.type, layout.getStride(), (const void*)(uintptr_t)offset);
+		else
+			glVertexAttribPointer(index, element.count, element.type, 
+				element.normalized, layout.getStride(), (const void*)(uintptr_t)offset);
+		glVertexAttribDivisor(index, element.divisor);
 		offset += element.count * VertexBufferElement::getSizeOfType(element.type);
 	}
+	m_attributeCount += layout.getCount();
+}
+
+void VertexArray::setIndexBuffer(const IndexBuffer& ib)
+{
+	bind();
+	ib.bind();
 }
 
 void VertexArray::bind() const
 {
-	glBindVertexArray(m_rendererID);
+	RenderState::bindVertexArray(m_rendererID);
 }
 
 void VertexArray::unbind() const
 {
-	glBindVertexArray(0);
+	RenderState::bindVertexArray(0);
 }
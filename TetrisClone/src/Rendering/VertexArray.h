@@ -1,18 +1,33 @@
 #pragma once
 #include "VertexBuffer.h"
-#include "VertexBufferLayout.h"
+
+class IndexBuffer;
+class VertexBufferLayout;
 
 class VertexArray
 {
 public:
 	VertexArray();
 	~VertexArray();
+	// Owns its GL object, so it can be moved but never copied
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
+	VertexArray(VertexArray&& other) noexcept;
+	VertexArray& operator=(VertexArray&& other) noexcept;
 
 	void addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	// Records the index buffer in the vertex array, so draws from it need only bind the array
+	void setIndexBuffer(const IndexBuffer& ib);
 
 	void bind() const;
 	void unbind() const;
 
+	inline unsigned int getRendererID() const { return m_rendererID; }
+
+private:
+	void release();
+
 private:
 	unsigned int m_rendererID;
+	unsigned int m_attributeCount;
 };
\ No newline at end of file
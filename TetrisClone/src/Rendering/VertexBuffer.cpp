@@ -1,26 +1,209 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
+#include "RenderState.h"
 #include "GL/glew.h"
 #include "GLFW/glfw3.h"
+#include <utility>
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+	: m_size(size), m_regionSize(0), m_regionCount(0), m_region(0), m_cursor(0), m_reserved(0),
+	m_mapped(nullptr), m_staging(nullptr), m_fences()
 {
 	glGenBuffers(1, &m_rendererID);
-	glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
 	glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 }
 
+VertexBuffer::VertexBuffer(unsigned int size)
+	: m_size(size), m_regionSize(0), m_regionCount(0), m_region(0), m_cursor(0), m_reserved(0),
+	m_mapped(nullptr), m_staging(nullptr), m_fences()
+{
+	glGenBuffers(1, &m_rendererID);
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+}
+
+VertexBuffer::VertexBuffer(unsigned int regionSize, unsigned int regionCount)
+	: m_regionSize(regionSize), m_regionCount(regionCount < kMaxRegions ? regionCount : kMaxRegions), m_region(0),
+	m_cursor(0), m_reserved(0), m_mapped(nullptr), m_staging(nullptr), m_fences()
+{
+	glGenBuffers(1, &m_rendererID);
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+
+	if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage)
+	{
+		// Coherent persistent mapping lets the CPU write straight into memory the GPU reads from,
+		// with the fences keeping it off regions that queued draws still use
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		m_size = m_regionSize * m_regionCount;
+		glBufferStorage(GL_ARRAY_BUFFER, m_size, nullptr, flags);
+		m_mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, m_size, flags);
+	}
+	else
+	{
+		// Without buffer storage the first upload of each frame orphans a single region, so the ring collapses to one
+		m_regionCount = 1;
+		m_size = m_regionSize;
+		glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, GL_STREAM_DRAW);
+		m_staging = new unsigned char[m_size];
+	}
+}
+
+VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept : VertexBuffer()
+{
+	*this = std::move(other);
+}
+
+VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	release();
+	m_rendererID = other.m_rendererID;
+	m_size = other.m_size;
+	m_regionSize = other.m_regionSize;
+	m_regionCount = other.m_regionCount;
+	m_region = other.m_region;
+	m_cursor = other.m_cursor;
+	m_reserved = other.m_reserved;
+	m_mapped = other.m_mapped;
+	m_staging = other.m_staging;
+	for (unsigned int i = 0; i < kMaxRegions; i++)
+	{
+		m_fences[i] = other.m_fences[i];
+		other.m_fences[i] = nullptr;
+	}
+
+	other.m_rendererID = 0;
+	other.m_size = 0;
+	other.m_regionSize = 0;
+	other.m_regionCount = 0;
+	other.m_mapped = nullptr;
+	other.m_staging = nullptr;
+	return *this;
+}
+
 VertexBuffer::~VertexBuffer()
 {
+	release();
+}
+
+void VertexBuffer::release()
+{
+	if (m_rendererID == 0)
+		return;
+
+	for (unsigned int i = 0; i < kMaxRegions; i++)
+	{
+		if (m_fences[i])
+			glDeleteSync((GLsync)m_fences[i]);
+		m_fences[i] = nullptr;
+	}
+
+	if (m_mapped)
+	{
+		RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+	delete[] m_staging;
+
+	m_staging = nullptr;
+	m_mapped = nullptr;
+
+	RenderState::onBufferDeleted(m_rendererID);
 	glDeleteBuffers(1, &m_rendererID);
+	m_rendererID = 0;
+}
+
+void VertexBuffer::setData(const void* data, unsigned int size)
+{
+	// Orphan the old storage first so the driver can hand out fresh memory instead of
+	// waiting for draws still reading last frame's contents
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+	glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+}
+
+void VertexBuffer::setSubData(unsigned int offset, const void* data, unsigned int size)
+{
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
+
+void* VertexBuffer::map(unsigned int size)
+{
+	if (m_cursor + size > m_regionSize)
+		advanceRegion();
+
+	if (!m_mapped)
+	{
+		m_reserved = size;
+		return m_staging;
+	}
+
+	// Block only if the GPU is still reading what was written into this region last time round
+	GLsync fence = (GLsync)m_fences[m_region];
+	if (fence)
+	{
+		GLbitfield waitFlags = 0;
+		GLuint64 timeout = 0;
+		for (;;)
+		{
+			const GLenum result = glClientWaitSync(fence, waitFlags, timeout);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+				break;
+
+			// Flush on the first miss so the fence is guaranteed to be reached
+			waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			timeout = 1000000;
+		}
+		glDeleteSync(fence);
+		m_fences[m_region] = nullptr;
+	}
+
+	m_reserved = size;
+	return m_mapped + m_region * m_regionSize + m_cursor;
+}
+
+unsigned int VertexBuffer::unmap(unsigned int usedSize)
+{
+	const unsigned int used = usedSize < m_reserved ? usedSize : m_reserved;
+	const unsigned int offset = m_region * m_regionSize + m_cursor;
+	if (!m_mapped)
+	{
+		// Orphan only when starting over, since draws queued earlier in the frame still read the front
+		RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+		if (m_cursor == 0)
+			glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, offset, used, m_staging);
+	}
+
+	m_cursor += used;
+	m_reserved = 0;
+	return offset;
+}
+
+void VertexBuffer::fence()
+{
+	if (m_cursor > 0)
+		advanceRegion();
+}
+
+void VertexBuffer::advanceRegion()
+{
+	if (m_mapped)
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_region = (m_region + 1) % m_regionCount;
+	m_cursor = 0;
 }
 
 void VertexBuffer::bind() const
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, m_rendererID);
 }
 
 void VertexBuffer::unbind() const
 {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderState::bindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -3,13 +3,57 @@
 class VertexBuffer
 {
 public:
-	VertexBuffer() : m_rendererID(0) {}
+	static constexpr unsigned int kMaxRegions = 4;
+
+	VertexBuffer() : m_rendererID(0), m_size(0), m_regionSize(0), m_regionCount(0), m_region(0), m_cursor(0),
+		m_reserved(0), m_mapped(nullptr), m_staging(nullptr), m_fences() {}
 	VertexBuffer(const void* data, unsigned int size);
+	// Allocates an uninitialized buffer meant to be rewritten every frame with setData
+	explicit VertexBuffer(unsigned int size);
+	// Allocates a streaming ring of regionCount regions of regionSize bytes each, persistently mapped
+	// when the driver supports buffer storage and falling back to orphaning uploads when it does not
+	VertexBuffer(unsigned int regionSize, unsigned int regionCount);
 	~VertexBuffer();
+	// Owns its GL object, so it can be moved but never copied
+	VertexBuffer(const VertexBuffer&) = delete;
+	VertexBuffer& operator=(const VertexBuffer&) = delete;
+	VertexBuffer(VertexBuffer&& other) noexcept;
+	VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+
+	void setData(const void* data, unsigned int size);
+	// Overwrites part of the buffer in place, leaving the rest of the contents alone
+	void setSubData(unsigned int offset, const void* data, unsigned int size);
+
+	// Streaming only. map hands out size writable bytes, waiting for the GPU if the region it lands
+	// in is still being read. unmap publishes the first usedSize of them and returns their offset
+	// in the buffer. fence marks the current region as in use by the draws just issued and moves on.
+	// A map larger than the space left in the region moves on as well, so anything drawn from the
+	// region must have been issued first.
+	void* map(unsigned int size);
+	unsigned int unmap(unsigned int usedSize);
+	void fence();
+	inline unsigned int getRegionSpace() const { return m_regionSize - m_cursor; }
 
 	void bind() const;
 	void unbind() const;
 
+	inline unsigned int getSize() const { return m_size; }
+	inline bool isPersistent() const { return m_mapped != nullptr; }
+
+private:
+	void advanceRegion();
+	void release();
+
 private:
 	unsigned int m_rendererID;
+	unsigned int m_size;
+
+	unsigned int m_regionSize;
+	unsigned int m_regionCount;
+	unsigned int m_region;
+	unsigned int m_cursor;
+	unsigned int m_reserved;
+	unsigned char* m_mapped;
+	unsigned char* m_staging;
+	void* m_fences[kMaxRegions];
 };
\ No newline at end of file
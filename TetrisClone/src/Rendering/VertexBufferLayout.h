@@ -1,6 +1,4 @@
 #pragma once
-#include <vector>
-#include <stdexcept>
 #include <GL/glew.h>
 
 struct VertexBufferElement
@@ -8,6 +6,11 @@ struct VertexBufferElement
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	// Instances drawn per attribute step, 0 advancing once per vertex
+	unsigned int divisor;
+
+	// Unnormalized integers reach the shader as ints rather than being converted to float
+	inline bool isInteger() const { return type != GL_FLOAT && !normalized; }
 
 	static unsigned int getSizeOfType(unsigned int type)
 	{
@@ -23,43 +26,55 @@ struct VertexBufferElement
 	}
 };
 
+// Layouts are built on the stack while setting up a vertex array, so the elements live in a fixed array
 class VertexBufferLayout
 {
 public:
-	VertexBufferLayout() : m_stride(0) {}
+	static constexpr unsigned int kMaxElements = 8;
+
+	VertexBufferLayout() : m_elements(), m_count(0), m_stride(0) {}
 
 	template<typename T>
-	void push(unsigned int count)
+	void push(unsigned int count, unsigned int divisor = 0)
 	{
-		std::runtime_error(false, "Unsupported type");
+		static_assert(sizeof(T) == 0, "Unsupported type");
 	}
 
-	template<>
-	void push<float>(unsigned int count)
-	{
-		m_elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_stride += VertexBufferElement::getSizeOfType(GL_FLOAT) * count;
-	}
+	inline unsigned int getStride() const { return m_stride; }
 
-	template<>
-	void push<unsigned int>(unsigned int count)
-	{
-		m_elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_stride += VertexBufferElement::getSizeOfType(GL_UNSIGNED_INT) * count;
-	}
+	inline const VertexBufferElement* getElements() const { return m_elements; }
+	inline unsigned int getCount() const { return m_count; }
 
-	template<>
-	void push<unsigned char>(unsigned int count)
+private:
+	void pushElement(unsigned int type, unsigned int count, unsigned char normalized, unsigned int divisor)
 	{
-		m_elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_stride += VertexBufferElement::getSizeOfType(GL_UNSIGNED_BYTE) * count;
-	}
+		if (m_count == kMaxElements)
+			return;
 
-	inline unsigned int getStride() const { return m_stride; }
-
-	inline const std::vector<VertexBufferElement>& getElements() const { return m_elements; }
+		m_elements[m_count++] = { type, count, normalized, divisor };
+		m_stride += VertexBufferElement::getSizeOfType(type) * count;
+	}
 
 private:
-	std::vector<VertexBufferElement> m_elements;
+	VertexBufferElement m_elements[kMaxElements];
+	unsigned int m_count;
 	unsigned int m_stride;
-};
\ No newline at end of file
+};
+
+template<>
+inline void VertexBufferLayout::push<float>(unsigned int count, unsigned int divisor)
+{
+	pushElement(GL_FLOAT, count, GL_FALSE, divisor);
+}
+
+template<>
+inline void VertexBufferLayout::push<unsigned int>(unsigned int count, unsigned int divisor)
+{
+	pushElement(GL_UNSIGNED_INT, count, GL_FALSE, divisor);
+}
+
+template<>
+inline void VertexBufferLayout::push<unsigned char>(unsigned int count, unsigned int divisor)
+{
+	pushElement(GL_UNSIGNED_BYTE, count, GL_TRUE, divisor);
+}
\ No newline at end of file
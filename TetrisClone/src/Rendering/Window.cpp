@@ -5,16 +5,81 @@
 #include "GLFW/glfw3.h"
 #include <stdexcept>
 #include <iostream>
-#include "IndexBuffer.h"
-#include "VertexArray.h"
-#include "Shader.h"
+#include <cstdio>
+#include <cstring>
+#include "Renderer.h"
+#include "DrawList.h"
+#include "RenderState.h"
+#include "BoardRenderer.h"
+#include "ParticleSystem.h"
+#include "Texture.h"
+#include "Font.h"
+#include "TextLayer.h"
+#include "UniformBuffer.h"
+#include "ShaderLibrary.h"
+#include "AssetLoader.h"
+#include "Core/AssetArchive.h"
+#include "Framebuffer.h"
+#include "FrameCapture.h"
+#include "GpuTimer.h"
+#include "Core/Profiler.h"
+#include "Core/KeyboardInput.h"
+#include "Game/Game.h"
+
+namespace
+{
+	// Grey bevelled block, lit from the top left. It is tinted by each piece's color when drawn.
+	void buildBlockSkin(uint8_t* pixels, int size)
+	{
+		const int bevel = size / 8;
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				float shade = 0.85f - 0.15f * (float)y / size;
+				if (x < bevel || y < bevel)
+					shade = 1.0f;
+				if (x >= size - bevel || y >= size - bevel)
+					shade = 0.55f;
+
+				uint8_t* pixel = pixels + (y * size + x) * 4;
+				pixel[0] = pixel[1] = pixel[2] = (uint8_t)(shade * 255.0f);
+				pixel[3] = 255;
+			}
+		}
+	}
+}
 
-Window::Window(const char* title, int width, int height)
+Window::Window(const char* title, int width, int height, bool headless, const char* archivePath)
+	: m_frameArena(kFrameArenaSize)
 {
     m_title = title;
 	m_width = width;
 	m_height = height;
+	m_outputWidth = width;
+	m_outputHeight = height;
+	m_resized = true;
+	m_internalHeight = 0;
 	m_window = nullptr;
+	m_headless = headless;
+	m_capture = nullptr;
+	m_gpuTimer = nullptr;
+	m_frameIndex = 0;
+	m_keyboardInput = nullptr;
+	m_allocationExpected = false;
+	m_assets = nullptr;
+	m_archivePath = archivePath;
+	m_archive = nullptr;
+	m_loading = true;
+	m_shader = nullptr;
+	m_cellShader = nullptr;
+	m_font = nullptr;
+	m_boardRenderer = nullptr;
+	m_particles = nullptr;
+	m_effectPieces = 0;
+	m_lastRenderTime = 0.0;
+	m_hudText = nullptr;
+	m_debugText = nullptr;
 
 	// If initialization fails, throw an exception
 	if (!init(title, width, height))
@@ -32,6 +97,42 @@ Window::Window(const char* title, int width, int height)
 
 Window::~Window()
 {
+	// Release GL objects while the context still exists, writing out any readbacks still in flight
+	if (m_capture)
+		m_capture->collect(true);
+	delete m_capture;
+	delete m_gpuTimer;
+	m_capture = nullptr;
+	m_gpuTimer = nullptr;
+	m_framebuffer = Framebuffer();
+	m_sceneTarget = Framebuffer();
+
+	// The loader goes first so its workers stop before anything they decode for is destroyed
+	delete m_assets;
+	delete m_archive;
+	m_assets = nullptr;
+	m_archive = nullptr;
+
+	RenderState::useProgram(0);
+	delete m_boardRenderer;
+	delete m_particles;
+	delete m_hudText;
+	delete m_debugText;
+	delete m_atlas;
+	delete m_renderer;
+	delete m_shaderLibrary;
+	m_frameUniforms = UniformBuffer();
+	m_boardRenderer = nullptr;
+	m_particles = nullptr;
+	m_hudText = nullptr;
+	m_debugText = nullptr;
+	m_font = nullptr;
+	m_atlas = nullptr;
+	m_renderer = nullptr;
+	m_shaderLibrary = nullptr;
+	m_cellShader = nullptr;
+	m_shader = nullptr;
+
 	// Destroy window and terminate GLFW
 	glfwDestroyWindow(m_window);
 	glfwTerminate();
@@ -41,19 +142,6 @@ Window::~Window()
 	m_width = 0;
 	m_height = 0;
 	m_title = nullptr;
-
-	m_vertexBuffer->unbind();
-	m_indexBuffer->unbind();
-	m_vertexArray->unbind();
-	m_shader->Unbind();
-	delete m_vertexBuffer;
-	delete m_indexBuffer;
-	delete m_vertexArray;
-	delete m_shader;
-	m_vertexBuffer = nullptr;
-	m_indexBuffer = nullptr;
-	m_vertexArray = nullptr;
-	m_shader = nullptr;
 }
 
 bool Window::init(const char* title, int width, int height)
@@ -62,11 +150,15 @@ bool Window::init(const char* title, int width, int height)
 	if (!glfwInit())
 		return false;
 
-	// Set core profile
+	// Set core profile. Headless runs ask for 4.3 so software rasterizers such as llvmpipe qualify
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, m_headless ? 3 : 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+	// Headless windows are never shown; everything is drawn into an offscreen framebuffer instead
+	if (m_headless)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
 	// Print GLFW Version
 	int major, minor, revision;
 	glfwGetVersion(&major, &minor, &revision);
@@ -85,6 +177,15 @@ bool Window::init(const char* title, int width, int height)
 	// Make the window's context current
 	glfwMakeContextCurrent(m_window);
 
+	// Route key events back to this window so it can hand them to its input
+	glfwSetWindowUserPointer(m_window, this);
+	glfwSetKeyCallback(m_window, GLFWKeyCallback);
+	glfwSetFramebufferSizeCallback(m_window, GLFWFramebufferSizeCallback);
+
+	// Headless frames are the offscreen framebuffer's size; a window is measured in pixels, not screen coordinates
+	if (!m_headless)
+		glfwGetFramebufferSize(m_window, &m_outputWidth, &m_outputHeight);
+
 	// Initialize GLEW
 	if (glewInit() != GLEW_OK)
 	{
@@ -103,69 +204,502 @@ bool Window::init(const char* title, int width, int height)
 	// Print OpenGL Version
 	std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
 
-	// Create GL buffer for triangle
-	float positions[] =
-	{
-		-0.5f, -0.5f,
-		 0.5f, -0.5f,
-		 0.5f,  0.5f,
-		-0.5f,  0.5f
-	};
+	// Glyph edges and the overlay are translucent
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	unsigned int indices[] =
+	// Every draw is submitted to one list and issued in state order at the end of the frame
+	m_renderer = new Renderer(m_drawList);
+
+	// Shaders are handed to the library once built, so edits to their files are picked up while running.
+	// They and the font load in the background while a loading screen is drawn; see finishLoading.
+	m_shaderLibrary = new ShaderLibrary();
+	m_assets = new AssetLoader(*m_shaderLibrary);
+	if (m_archivePath)
 	{
-		0, 1, 2,
-		2, 3, 0
-	};
+		m_archive = new AssetArchive(m_archivePath);
+		if (m_archive->isValid())
+		{
+			m_assets->setArchive(m_archive);
+		}
+		else
+		{
+			std::cerr << "Asset archive " << m_archivePath << " is missing or malformed, using loose files" << std::endl;
+			delete m_archive;
+			m_archive = nullptr;
+		}
+	}
+	m_shaderAsset = m_assets->loadShader("res/shaders/Basic.shader");
+	m_cellShaderAsset = m_assets->loadShader("res/shaders/Cell.shader");
 
-	// Create vertex array object
-	m_vertexArray = new VertexArray();
-	m_vertexBuffer = new VertexBuffer(positions, 4 * 2 * sizeof(float));
-	VertexBufferLayout layout;
-	layout.push<float>(2);
-	m_vertexArray->addBuffer(*m_vertexBuffer, layout);
+	// Effects are simulated by a compute shader, so they are left out on contexts older than 4.3
+	if (GLEW_VERSION_4_3)
+	{
+		m_particleUpdateAsset = m_assets->loadShader("res/shaders/ParticleUpdate.shader");
+		m_particleAsset = m_assets->loadShader("res/shaders/Particle.shader");
+	}
 
-	// Enable vertex attributes
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, 0);
+	// Block skins and glyphs share one atlas so a layer needs a single texture binding
+	buildAtlas();
 
-	// Create index buffer object
-	m_indexBuffer = new IndexBuffer(indices, 6);
+	// Projection and time are uploaded once per frame into a block every program reads
+	m_frameUniforms = UniformBuffer(sizeof(FrameUniforms), UniformBuffer::kFrameBinding);
 
-	// Create shader
-	m_shader = new Shader("res/shaders/Basic.shader");
-	m_shader->Bind();
+	if (m_headless)
+		m_framebuffer = Framebuffer(width, height);
 
-	// Unbind the buffer
-	m_vertexArray->unbind();
-	m_shader->Unbind();
-	m_vertexBuffer->unbind();
-	m_indexBuffer->unbind();
+	m_gpuTimer = new GpuTimer();
 
     return true;
 }
 
-void Window::update()
+bool Window::finishLoading()
 {
+	m_shader = m_shaderAsset.get();
+	m_cellShader = m_cellShaderAsset.get();
+	m_font = m_fontAsset.get();
+	if (!m_shader || !m_cellShader || !m_font)
+	{
+		std::cerr << "Required assets failed to load" << std::endl;
+		glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+		return false;
+	}
+
+	m_shader->BindUniformBlock("Frame", UniformBuffer::kFrameBinding);
+	m_cellShader->BindUniformBlock("Frame", UniformBuffer::kFrameBinding);
+
+	// The settled board is drawn instanced straight from its row bitmasks
+	m_boardRenderer = new BoardRenderer(*m_cellShader, m_drawList, m_atlas->getTexture(), m_blockSkin);
+	buildHud();
 
-	if (!glfwWindowShouldClose(m_window))
+	// The game plays on without effects if their shaders are missing
+	Shader* particleUpdate = m_particleUpdateAsset.get();
+	Shader* particleDraw = m_particleAsset.get();
+	if (particleUpdate && particleDraw)
 	{
-		// Clear the buffer
-		glClear(GL_COLOR_BUFFER_BIT);
+		particleDraw->BindUniformBlock("Frame", UniformBuffer::kFrameBinding);
+		m_particles = new ParticleSystem(*particleUpdate, *particleDraw, m_drawList);
+	}
+	else
+	{
+		std::cerr << "Particle shaders are unavailable, playing without effects" << std::endl;
+	}
+	m_lastRenderTime = glfwGetTime();
 
-		m_shader->Bind();
-		m_vertexArray->bind();
-		m_indexBuffer->bind();
+	m_loading = false;
+	return true;
+}
 
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+void Window::renderLoadingScreen()
+{
+	PROFILE_SCOPE("Loading Screen");
+	m_assets->update(kAssetUploadBudgetMs);
+
+	bindOutput();
+
+	// No program is ready to draw with yet, so the progress bar is cleared into scissor rectangles
+	const int total = m_assets->getRequestedCount();
+	const float progress = total > 0 ? (float)m_assets->getFinishedCount() / total : 1.0f;
+	const int barWidth = m_outputWidth / 2;
+	const int barHeight = m_outputHeight / 40 > 4 ? m_outputHeight / 40 : 4;
+	const int barX = (m_outputWidth - barWidth) / 2;
+	const int barY = (m_outputHeight - barHeight) / 2;
+
+	glClearColor(0.05f, 0.05f, 0.07f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(barX, barY, barWidth, barHeight);
+	glClearColor(0.20f, 0.20f, 0.25f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glScissor(barX, barY, (int)(barWidth * progress), barHeight);
+	glClearColor(0.10f, 0.85f, 0.20f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	if (m_assets->isIdle())
+		finishLoading();
+}
 
-		// Swap the buffers
+void Window::render(const Game& game, float alpha)
+{
+	if (m_loading)
+	{
+		renderLoadingScreen();
+		m_allocationExpected = true;
+		return;
+	}
+
+	PROFILE_SCOPE("Render");
+	const bool profiling = Profiler::isEnabled();
+	if (profiling)
+		m_gpuTimer->beginFrame();
+	const RenderState::Counters lastFrameBinds = RenderState::getFrameCounters();
+	RenderState::resetFrameCounters();
+	m_frameArena.reset();
+
+	const bool resized = m_resized;
+	if (resized)
+		applyResize();
+
+	// The playfield is drawn into the internal target when there is one and everything else straight to the output
+	const bool scaled = m_sceneTarget.isValid();
+	if (scaled)
+		m_sceneTarget.bind();
+	else
+		bindOutput();
+
+	// Clear the buffer
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	const bool reloading = m_shaderLibrary->update();
+
+	const double now = glfwGetTime();
+	FrameUniforms frame = {};
+	memcpy(frame.projection, m_projection, sizeof(m_projection));
+	frame.time[0] = (float)now;
+	m_frameUniforms.setData(&frame, sizeof(frame));
+
+	// Long stalls are stepped as a tenth of a second so particles do not jump across the screen
+	const double elapsed = now - m_lastRenderTime;
+	m_lastRenderTime = now;
+
+	m_renderer->resetStats();
+	m_renderer->begin(*m_shader, RenderLayer::Pieces, &m_atlas->getTexture());
+	drawGame(game, alpha);
+	// Units are square under the projection, so particles need no aspect correction
+	if (m_particles)
+		m_particles->update(elapsed < 0.1 ? (float)elapsed : 0.1f, 1.0f);
+	updateHud(game);
+	m_hudText->draw(m_drawList, *m_shader);
+	if (profiling)
+	{
+		m_renderer->begin(*m_shader, RenderLayer::Overlay);
+		drawProfilerOverlay();
+		updateDebugText(lastFrameBinds.issued, lastFrameBinds.skipped);
+		m_debugText->draw(m_drawList, *m_shader);
+	}
+	m_renderer->end();
+	if (scaled)
+	{
+		// Scale the playfield up to the output, then draw the HUD and overlay over it at full resolution
+		m_drawList.executeThrough(RenderLayer::Effects);
+		m_sceneTarget.blitTo(m_framebuffer.isValid() ? m_framebuffer.getRendererID() : 0, m_outputWidth, m_outputHeight);
+		glViewport(0, 0, m_outputWidth, m_outputHeight);
+	}
+	m_drawList.execute();
+	m_renderer->endFrame();
+
+	if (profiling)
+	{
+		const RenderState::Counters& counters = RenderState::getFrameCounters();
+		Profiler::recordCounter("Binds Issued", counters.issued);
+		Profiler::recordCounter("Binds Skipped", counters.skipped);
+		m_gpuTimer->endFrame();
+	}
+
+	// Queue this frame's readback and write out the ones the GPU has finished since
+	if (m_capture)
+	{
+		m_capture->collect();
+		m_capture->capture(m_frameIndex);
+	}
+	m_frameIndex++;
+	m_allocationExpected = reloading || resized || m_capture != nullptr;
+}
+
+void Window::applyResize()
+{
+	m_resized = false;
+
+	// Orthographic projection showing at least the whole design area, reaching further along
+	// whichever axis the output is relatively longer in
+	const float aspect = (float)m_outputWidth / m_outputHeight;
+	const float halfWidth = aspect > kDesignAspect ? aspect : kDesignAspect;
+	const float halfHeight = aspect > kDesignAspect ? 1.0f : kDesignAspect / aspect;
+	const float projection[16] =
+	{
+		1.0f / halfWidth, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f / halfHeight, 0.0f, 0.0f,
+		0.0f, 0.0f, -1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	memcpy(m_projection, projection, sizeof(projection));
+
+	// Keeps the output's shape so the upscale does not stretch; resize does nothing when the size is unchanged
+	if (m_internalHeight > 0 && m_internalHeight < m_outputHeight)
+		m_sceneTarget.resize((int)(m_internalHeight * aspect + 0.5f), m_internalHeight);
+	else
+		m_sceneTarget = Framebuffer();
+}
+
+void Window::bindOutput()
+{
+	if (m_framebuffer.isValid())
+	{
+		m_framebuffer.bind();
+		return;
+	}
+
+	RenderState::bindFramebuffer(0);
+	glViewport(0, 0, m_outputWidth, m_outputHeight);
+}
+
+void Window::setInternalHeight(int height)
+{
+	m_internalHeight = height;
+	m_resized = true;
+}
+
+void Window::swapBuffers()
+{
+	// There is nothing to present when drawing offscreen
+	if (!m_headless)
 		glfwSwapBuffers(m_window);
-		// Poll for events
-		glfwPollEvents();
+
+	// Input latency is measured up to here, the closest point to the screen the game can see
+	if (m_keyboardInput)
+		m_keyboardInput->onPresented();
+}
+
+void Window::setCaptureDirectory(const char* directory)
+{
+	if (!m_framebuffer.isValid())
+		return;
+
+	delete m_capture;
+	m_capture = new FrameCapture(m_framebuffer.getWidth(), m_framebuffer.getHeight(), directory);
+}
+
+void Window::pollEvents()
+{
+	glfwPollEvents();
+}
+
+void Window::waitEvents(double timeout)
+{
+	glfwWaitEventsTimeout(timeout);
+}
+
+void Window::setVSync(bool enabled)
+{
+	glfwSwapInterval(enabled ? 1 : 0);
+}
+
+bool Window::isMinimized() const
+{
+	return glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) != 0;
+}
+
+void Window::drawGame(const Game& game, float alpha)
+{
+	// Fit the visible field to the view's height; units are square, so the cells are too
+	const float cellHeight = 1.8f / Board::kVisibleHeight;
+	const float cellWidth = cellHeight;
+	const float left = -cellWidth * Board::kWidth * 0.5f;
+	const float top = 0.9f;
+
+	m_boardRenderer->draw(game.getBoard(), left, top, cellWidth, cellHeight);
+	emitEffects(game, left, top, cellWidth, cellHeight);
+
+	if (game.isGameOver())
+		return;
+
+	// Draw the falling piece over the board, easing it between the last two ticks when it only fell one row
+	const ActivePiece& piece = game.getActivePiece();
+	const ActivePiece& previous = game.getPreviousPiece();
+	float fall = 0.0f;
+	if (previous.type == piece.type && previous.rotation == piece.rotation && previous.x == piece.x && piece.y - previous.y == 1)
+		fall = alpha - 1.0f;
+
+	const PieceMask& mask = getPieceMask(piece.type, piece.rotation);
+	for (int r = mask.minY; r <= mask.maxY; r++)
+	{
+		const int y = piece.y + r;
+		if (y < Board::kHiddenRows)
+			continue;
+
+		const float rowTop = top - (y - Board::kHiddenRows + fall) * cellHeight;
+		for (int c = mask.minX; c <= mask.maxX; c++)
+		{
+			if ((mask.rows[r] >> c) & 1)
+				drawCell(left + (piece.x + c) * cellWidth, rowTop - cellHeight, cellWidth, cellHeight, (int)piece.type + 1);
+		}
+	}
+
+	// Hold box to the left of the field and the next queue to the right, at half cell size
+	const float previewWidth = cellWidth * 0.5f;
+	const float previewHeight = cellHeight * 0.5f;
+	if (game.getHeldPiece() != PieceType::None)
+		drawPreview(game.getHeldPiece(), left - 5.0f * previewWidth, top, previewWidth, previewHeight);
+
+	for (int i = 0; i < Game::kPreviewCount; i++)
+		drawPreview(game.getPreview(i), -left + previewWidth, top - i * 3.0f * previewHeight, previewWidth, previewHeight);
+}
+
+void Window::emitEffects(const Game& game, float left, float top, float cellWidth, float cellHeight)
+{
+	static const float kClearColor[4] = { 1.0f, 0.92f, 0.75f, 1.0f };
+	const int kParticlesPerClearedRow = 2500;
+	const int kParticlesPerDropRow = 40;
+
+	// A restarted game counts from zero again, which is not a lock
+	const int placed = game.getPiecesPlaced();
+	const bool locked = placed > m_effectPieces;
+	m_effectPieces = placed;
+	if (!m_particles || !locked)
+		return;
+
+	// Clearing more rows at once makes every one of them burst harder
+	const LockEvent& lock = game.getLastLock();
+	int cleared = 0;
+	for (uint32_t rows = lock.clearedRows; rows; rows &= rows - 1)
+		cleared++;
+
+	for (int y = Board::kHiddenRows; y < Board::kHeight; y++)
+	{
+		if ((lock.clearedRows >> y) & 1)
+		{
+			const float bottom = top - (y - Board::kHiddenRows + 1) * cellHeight;
+			m_particles->emit(left, bottom, cellWidth * Board::kWidth, cellHeight, kClearColor, kParticlesPerClearedRow * cleared,
+				0.6f + 0.15f * cleared, 1.2f, 0.4f, cellHeight * 0.08f);
+		}
+	}
+
+	if (lock.dropDistance == 0)
+		return;
+
+	// Dust kicked up under the lowest cell of each column the hard dropped piece landed on
+	const PieceMask& mask = getPieceMask(lock.piece.type, lock.piece.rotation);
+	const float* color = BoardRenderer::kPalette[(int)lock.piece.type + 1];
+	for (int c = mask.minX; c <= mask.maxX; c++)
+	{
+		int r = mask.maxY;
+		while (r >= mask.minY && !((mask.rows[r] >> c) & 1))
+			r--;
+
+		const int y = lock.piece.y + r;
+		if (r < mask.minY || y < Board::kHiddenRows)
+			continue;
+
+		const float bottom = top - (y - Board::kHiddenRows + 1) * cellHeight;
+		m_particles->emit(left + (lock.piece.x + c) * cellWidth, bottom, cellWidth, cellHeight * 0.1f, color,
+			kParticlesPerDropRow * lock.dropDistance, 0.3f, 0.5f, 0.25f, cellHeight * 0.05f);
 	}
 }
 
+void Window::drawPreview(PieceType type, float left, float top, float cellWidth, float cellHeight)
+{
+	const PieceMask& mask = getPieceMask(type, 0);
+	for (int r = mask.minY; r <= mask.maxY; r++)
+	{
+		const float rowTop = top - (r - mask.minY) * cellHeight;
+		for (int c = mask.minX; c <= mask.maxX; c++)
+		{
+			if ((mask.rows[r] >> c) & 1)
+				drawCell(left + c * cellWidth, rowTop - cellHeight, cellWidth, cellHeight, (int)type + 1);
+		}
+	}
+}
+
+void Window::drawProfilerOverlay()
+{
+	// Recent frame times as bars along the bottom left, 16.7 ms reaching the marker line
+	static const float kGood[4] = { 0.20f, 0.80f, 0.30f, 0.85f };
+	static const float kSlow[4] = { 0.90f, 0.25f, 0.20f, 0.85f };
+	static const float kMarker[4] = { 1.0f, 1.0f, 1.0f, 0.5f };
+	static const float kPercentile[4] = { 0.95f, 0.85f, 0.20f, 0.85f };
+	const float budgetMs = 1000.0f / 60.0f;
+	const float left = -1.30f;
+	const float bottom = -0.98f;
+	const float barWidth = 0.8f / Profiler::kRecentFrameCount;
+	const float budgetHeight = 0.2f;
+
+	float* frames = m_frameArena.allocateArray<float>(Profiler::kRecentFrameCount);
+	if (!frames)
+		return;
+
+	const int count = Profiler::getRecentFrames(frames, Profiler::kRecentFrameCount);
+	for (int i = 0; i < count; i++)
+	{
+		const float height = frames[i] / budgetMs * budgetHeight;
+		m_renderer->drawQuad(left + i * barWidth, bottom, barWidth, height < 2.0f * budgetHeight ? height : 2.0f * budgetHeight,
+			frames[i] > budgetMs ? kSlow : kGood);
+	}
+
+	const Profiler::FrameStats stats = Profiler::getFrameStats();
+	const float graphWidth = barWidth * Profiler::kRecentFrameCount;
+	m_renderer->drawQuad(left, bottom + budgetHeight, graphWidth, 0.004f, kMarker);
+	m_renderer->drawQuad(left, bottom + (float)stats.p99Ms / budgetMs * budgetHeight, graphWidth, 0.004f, kPercentile);
+}
+
+void Window::drawCell(float x, float y, float width, float height, int color)
+{
+	// Leave a small gap between cells
+	const float gapX = width * 0.05f;
+	const float gapY = height * 0.05f;
+	m_renderer->drawQuad(x + gapX, y + gapY, width - 2.0f * gapX, height - 2.0f * gapY, BoardRenderer::kPalette[color], m_blockSkin);
+}
+
+void Window::buildAtlas()
+{
+	const int skinSize = 32;
+	uint8_t skin[skinSize * skinSize * 4];
+	buildBlockSkin(skin, skinSize);
+
+	m_atlas = new TextureAtlas(512, 512);
+	if (!m_atlas->add(skinSize, skinSize, skin, m_blockSkin))
+		std::cerr << "Texture atlas has no room for the block skin" << std::endl;
+	m_atlas->upload();
+	m_fontAsset = m_assets->loadFont(*m_atlas);
+}
+
+void Window::buildHud()
+{
+	static const float kText[4] = { 0.90f, 0.90f, 0.95f, 1.0f };
+	static const float kDebugText[4] = { 1.0f, 1.0f, 1.0f, 0.85f };
+
+	// Glyphs keep the font's 5:7 shape, and stay inside the design area whatever the window's shape
+	const float glyphHeight = 0.05f;
+	const float glyphWidth = glyphHeight * Font::kGlyphColumns / Font::kGlyphRows;
+	const float left = -1.25f;
+
+	m_hudText = new TextLayer(*m_font, m_atlas->getTexture(), RenderLayer::Hud);
+	m_scoreText = m_hudText->addString(left, 0.30f, glyphWidth, glyphHeight, kText, 16);
+	m_levelText = m_hudText->addString(left, 0.20f, glyphWidth, glyphHeight, kText, 16);
+	m_linesText = m_hudText->addString(left, 0.10f, glyphWidth, glyphHeight, kText, 16);
+
+	m_debugText = new TextLayer(*m_font, m_atlas->getTexture(), RenderLayer::Overlay);
+	m_frameTimeText = m_debugText->addString(-1.30f, -0.45f, glyphWidth * 0.6f, glyphHeight * 0.6f, kDebugText, 40);
+	m_bindsText = m_debugText->addString(-1.30f, -0.50f, glyphWidth * 0.6f, glyphHeight * 0.6f, kDebugText, 40);
+}
+
+void Window::updateHud(const Game& game)
+{
+	// Formatted on the stack; the layer only lays the text out again when it differs
+	char text[TextLayer::kMaxStringLength + 1];
+	snprintf(text, sizeof(text), "SCORE %llu", (unsigned long long)game.getScore());
+	m_hudText->setText(m_scoreText, text);
+	snprintf(text, sizeof(text), "LEVEL %d", game.getLevel());
+	m_hudText->setText(m_levelText, text);
+	snprintf(text, sizeof(text), "LINES %d", game.getLines());
+	m_hudText->setText(m_linesText, text);
+}
+
+void Window::updateDebugText(unsigned int binds, unsigned int skippedBinds)
+{
+	const Profiler::FrameStats stats = Profiler::getFrameStats();
+	const size_t size = TextLayer::kMaxStringLength + 1;
+	char* text = m_frameArena.allocateArray<char>(size);
+	if (!text)
+		return;
+
+	snprintf(text, size, "P50 %.2f  P99 %.2f  MAX %.2f MS", stats.p50Ms, stats.p99Ms, stats.maxMs);
+	m_debugText->setText(m_frameTimeText, text);
+	snprintf(text, size, "BINDS %u  SKIPPED %u  GPU %.2f MS", binds, skippedBinds, m_gpuTimer->getLastFrameMs());
+	m_debugText->setText(m_bindsText, text);
+}
+
 void Window::setWindowSize(int width, int height)
 {
 	m_width = width;
@@ -181,4 +715,25 @@ bool Window::windowShouldClose()
 void Window::GLFWErrorMessageCallback(int error, const char* description)
 {
 	std::cerr << "GLFW Error: " << description << std::endl;
+}
+
+void Window::GLFWFramebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+	// Minimizing reports a zero size, which is ignored so the last real one is kept. A headless window
+	// always draws into its own framebuffer, whatever happens to the hidden window.
+	Window* owner = (Window*)glfwGetWindowUserPointer(window);
+	if (!owner || owner->m_headless || width <= 0 || height <= 0)
+		return;
+
+	owner->m_outputWidth = width;
+	owner->m_outputHeight = height;
+	owner->m_resized = true;
+	glfwGetWindowSize(window, &owner->m_width, &owner->m_height);
+}
+
+void Window::GLFWKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	Window* owner = (Window*)glfwGetWindowUserPointer(window);
+	if (owner && owner->m_keyboardInput)
+		owner->m_keyboardInput->onKey(key, action);
 }
\ No newline at end of file
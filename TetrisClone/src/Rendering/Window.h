@@ -1,18 +1,65 @@
+#pragma once
+#include <cstdint>
+#include "TextureAtlas.h"
+#include "DrawList.h"
+#include "UniformBuffer.h"
+#include "Framebuffer.h"
+#include "Core/FrameArena.h"
+#include "AssetLoader.h"
 
 class GLFWwindow;
-class VertexBuffer;
-class IndexBuffer;
-class VertexArray;
+class Renderer;
+class BoardRenderer;
+class ParticleSystem;
+class FrameCapture;
+class GpuTimer;
 class Shader;
+class Font;
+class TextLayer;
+class KeyboardInput;
+class ShaderLibrary;
+class AssetArchive;
+class Game;
+enum class PieceType : uint8_t;
 
 class Window
 {
 
 public:
-	Window(const char* title, int width, int height);
+	// Room for a frame's transient data, see m_frameArena
+	static constexpr size_t kFrameArenaSize = 64 * 1024;
+	// Time per frame spent uploading loaded assets while the loading screen shows
+	static constexpr double kAssetUploadBudgetMs = 4.0;
+	// Layout is in units where the view spans -1 to 1 vertically and at least this far either side
+	// horizontally. A window of another shape sees more in the direction it is longer in.
+	static constexpr float kDesignAspect = 4.0f / 3.0f;
+
+	// A headless window stays hidden and renders into an offscreen framebuffer. Assets are read from
+	// the archive when one is given and from loose files under res otherwise.
+	Window(const char* title, int width, int height, bool headless = false, const char* archivePath = nullptr);
 	~Window();
 
-	void update();
+	void render(const Game& game, float alpha);
+	void swapBuffers();
+	void pollEvents();
+	void waitEvents(double timeout);
+
+	void setVSync(bool enabled);
+	bool isMinimized() const;
+
+	// Writes every rendered frame into the directory as an image. Only available when headless.
+	void setCaptureDirectory(const char* directory);
+	bool isHeadless() const { return m_headless; }
+	// Until the shaders and font have loaded, render only draws a loading screen
+	inline bool isLoading() const { return m_loading; }
+	// Hot reloads and frame capture allocate by design, so the last frame rendered with either is not steady state
+	inline bool isAllocationExpected() const { return m_allocationExpected; }
+
+	// Key events received while polling are forwarded to the input, if one is set
+	inline void setKeyboardInput(KeyboardInput* input) { m_keyboardInput = input; }
+	// Draws the playfield at this many pixels high and scales it up to the window, so fill rate stays
+	// bounded however large the window is. 0, or a height the window does not exceed, draws at full size.
+	void setInternalHeight(int height);
 
 	int getWidth() const { return m_width; }
 	int getHeight() const { return m_height; }
@@ -21,18 +68,76 @@ public:
 	bool windowShouldClose();
 
 	static void GLFWErrorMessageCallback(int error, const char* description);
+	static void GLFWKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+	static void GLFWFramebufferSizeCallback(GLFWwindow* window, int width, int height);
 
 private:
 	bool init(const char* title, int width, int height);
+	void renderLoadingScreen();
+	void applyResize();
+	void bindOutput();
+	bool finishLoading();
+	void drawGame(const Game& game, float alpha);
+	void emitEffects(const Game& game, float left, float top, float cellWidth, float cellHeight);
+	void drawPreview(PieceType type, float left, float top, float cellWidth, float cellHeight);
+	void drawProfilerOverlay();
+	void drawCell(float x, float y, float width, float height, int color);
+	void buildAtlas();
+	void buildHud();
+	void updateHud(const Game& game);
+	void updateDebugText(unsigned int binds, unsigned int skippedBinds);
 
 private:
 		GLFWwindow* m_window;
 		int m_width;
 		int m_height;
+		// Size in pixels of what is drawn to, which differs from the window size on high DPI displays
+		int m_outputWidth;
+		int m_outputHeight;
+		// Set when the size or internal height changed, and applied at the start of the next frame
+		bool m_resized;
+		float m_projection[16];
+		int m_internalHeight;
+		Framebuffer m_sceneTarget;
 		const char* m_title;
+		ShaderLibrary* m_shaderLibrary;
+		AssetLoader* m_assets;
+		const char* m_archivePath;
+		AssetArchive* m_archive;
+		AssetHandle<Shader> m_shaderAsset;
+		AssetHandle<Shader> m_cellShaderAsset;
+		AssetHandle<Font> m_fontAsset;
+		AssetHandle<Shader> m_particleUpdateAsset;
+		AssetHandle<Shader> m_particleAsset;
+		bool m_loading;
 		Shader* m_shader;
-		unsigned int m_vertexArrayObject;
-		VertexBuffer* m_vertexBuffer;
-		IndexBuffer* m_indexBuffer;
-		VertexArray* m_vertexArray;
+		Shader* m_cellShader;
+		DrawList m_drawList;
+		Renderer* m_renderer;
+		BoardRenderer* m_boardRenderer;
+		// Null when the context has no compute shaders, in which case there are no effects
+		ParticleSystem* m_particles;
+		// Pieces placed as of the last frame, to spot new locks, and when that frame was rendered
+		int m_effectPieces;
+		double m_lastRenderTime;
+		TextureAtlas* m_atlas;
+		AtlasRegion m_blockSkin;
+		Font* m_font;
+		TextLayer* m_hudText;
+		TextLayer* m_debugText;
+		int m_scoreText;
+		int m_levelText;
+		int m_linesText;
+		int m_frameTimeText;
+		int m_bindsText;
+		UniformBuffer m_frameUniforms;
+		bool m_headless;
+		Framebuffer m_framebuffer;
+		FrameCapture* m_capture;
+		GpuTimer* m_gpuTimer;
+		unsigned long long m_frameIndex;
+		// Transient per-frame data such as the profiler overlay, thrown away at the start of each render
+		FrameArena m_frameArena;
+		bool m_allocationExpected;
+		KeyboardInput* m_keyboardInput;
 };
\ No newline at end of file